@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Shooter.hpp"
+#include "GameEngine/GameEngine.hpp"
+#include "GameEngine/Game.hpp"
+#include "Enemy.hpp"
+#include "EnemyBullet.hpp"
+#include "Explosion.hpp"
+#include "SpawnStar.hpp"
+
+// Headless stress benchmark. Builds a scene from the game prefabs, runs the
+// engine uncapped for a number of ticks and prints the timings as JSON.
+//
+//   ShooterBenchmark --enemies 200 --enemy-bullets 2000 --explosions 1000 --stars --ticks 2000
+//
+// With --trace FILE the engine zones are also written as a Chrome trace.
+
+struct BenchmarkOptions {
+    int enemies = 0;
+    int enemyBullets = 0;
+    int explosions = 0;
+    bool stars = false;
+    int ticks = 1000;
+    int warmup = 100;
+    int workers = -1;
+    bool pipelined = false;
+    std::uint64_t seed = 0;
+    std::string trace;
+};
+
+static BenchmarkOptions options;
+static std::vector<double> frameTimes;
+static Uint64 benchmarkStart = 0;
+static Uint64 benchmarkEnd = 0;
+static std::size_t spritesDrawn = 0;
+static std::size_t spritesCulled = 0;
+
+// Keeps the number of enemies, enemy bullets and explosions at the requested
+// amount by topping up what left the screen or faded away.
+class StressScene {
+    struct TopUpTimeoutComponent {
+        float timeout;
+    };
+
+    struct StressSceneScript: public Script {
+        void OnUpdate(GameObject& self, float dt) {
+            auto& timeout = self.GetComponent<TopUpTimeoutComponent>().timeout;
+            timeout -= dt;
+            if(timeout > 0.0f) return;
+            timeout = 0.1f;
+
+            int enemies = 0, enemyBullets = 0, explosions = 0;
+
+            auto& reg = Registry::Get();
+            reg.view<const CollisionMaskComponent>(entt::exclude<DisabledTag>).each([&](const auto& mask) {
+                if(mask.category & ENEMY_COLLISION_LAYER) enemies++;
+                if(mask.category & ENEMY_BULLET_COLLISION_LAYER) enemyBullets++;
+            });
+            reg.view<const ParticleEmitterComponent>().each([&](const auto& emitter) {
+                explosions += static_cast<int>(emitter.particles.GetSize());
+            });
+
+            for(; enemies < options.enemies; enemies++) {
+                AddToGame( Enemy() );
+            }
+            for(; enemyBullets < options.enemyBullets; enemyBullets++) {
+                AddToGame( EnemyBullet(
+                    SCREEN_WIDTH - 32.0f, Game::GenerateRandom(0.0f, SCREEN_HEIGHT),
+                    0.0f, Game::GenerateRandom(0.0f, SCREEN_HEIGHT)) );
+            }
+            for(; explosions < options.explosions; explosions += 10) {
+                AddToGame( Explosion(Game::GenerateRandom(0.0f, SCREEN_WIDTH), Game::GenerateRandom(0.0f, SCREEN_HEIGHT), 10) );
+            }
+        }
+    };
+
+public:
+    void operator()() {
+        GameObject()
+            .AddComponent<TopUpTimeoutComponent>(0.0f)
+            .AddComponent<ScriptComponent>( StressSceneScript() );
+
+        if(options.stars) {
+            AddToGame( SpawnStar() );
+        }
+    }
+};
+
+// With a headless Setting every frame runs exactly one tick, so the time
+// between two updates is the frame time. Pipelined, the updates run on the
+// simulation thread and drawing happens next to them, so the time between two
+// updates is only the tick time and is reported as such.
+class FrameTimer {
+    struct FrameTimerScript: public Script {
+        int tick = 0;
+        Uint64 previous = 0;
+
+        void OnUpdate(GameObject& self, float dt) {
+            const Uint64 now = SDL_GetPerformanceCounter();
+            if(tick == options.warmup) {
+                benchmarkStart = now;
+            }
+            else if(tick > options.warmup) {
+                frameTimes.push_back(static_cast<double>(now - previous) * 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency()));
+                spritesDrawn += Game::GetRenderStats().drawn;
+                spritesCulled += Game::GetRenderStats().culled;
+            }
+            if(tick == options.warmup + options.ticks) {
+                benchmarkEnd = now;
+                Game::Quit();
+            }
+            previous = now;
+            tick++;
+        }
+    };
+
+public:
+    void operator()() {
+        GameObject()
+            .AddComponent<ScriptComponent>( FrameTimerScript() );
+    }
+};
+
+static double percentile(std::vector<double> sorted, double p) {
+    if(sorted.empty()) return 0.0;
+    const auto index = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Parked entities of prefab pools are not part of the scene
+template<typename Component>
+static std::size_t countActive() {
+    std::size_t count = 0;
+    for(auto entity : Registry::Get().view<Component>(entt::exclude<DisabledTag>)) {
+        count++;
+    }
+    return count;
+}
+
+static bool parseArguments(int argc, char* argv[]) {
+    for(int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if(arg == "--enemies" && hasValue) options.enemies = std::atoi(argv[++i]);
+        else if(arg == "--enemy-bullets" && hasValue) options.enemyBullets = std::atoi(argv[++i]);
+        else if(arg == "--explosions" && hasValue) options.explosions = std::atoi(argv[++i]);
+        else if(arg == "--stars") options.stars = true;
+        else if(arg == "--ticks" && hasValue) options.ticks = std::atoi(argv[++i]);
+        else if(arg == "--warmup" && hasValue) options.warmup = std::atoi(argv[++i]);
+        else if(arg == "--workers" && hasValue) options.workers = std::atoi(argv[++i]);
+        else if(arg == "--pipelined") options.pipelined = true;
+        else if(arg == "--seed" && hasValue) options.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if(arg == "--trace" && hasValue) options.trace = argv[++i];
+        else {
+            std::cerr << "Usage: " << argv[0]
+                << " [--enemies N] [--enemy-bullets N] [--explosions N] [--stars] [--ticks N] [--warmup N] [--workers N] [--pipelined] [--seed N] [--trace FILE]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if(!parseArguments(argc, argv)) return 1;
+
+    auto setting = Setting()
+        .SetTitle("Shooter Benchmark")
+        .SetLogicalSize(SCREEN_WIDTH, SCREEN_HEIGHT)
+        .SetWindowSize(SCREEN_WIDTH, SCREEN_HEIGHT)
+        .SetSecondPerFrame(SECOND_PER_FRAME)
+        .SetCollidesWith(PLAYER_BULLET_COLLISION_LAYER, ENEMY_COLLISION_LAYER)
+        .SetCollidesWith(PLAYER_COLLISION_LAYER, ENEMY_COLLISION_LAYER | ENEMY_BULLET_COLLISION_LAYER)
+        .SetCollidesWith(SCORE_POD_COLLISION_LAYER, PLAYER_COLLISION_LAYER)
+        .SetContinuousCollision(PLAYER_BULLET_COLLISION_LAYER | ENEMY_BULLET_COLLISION_LAYER)
+        .SetHeadless(true)
+        .SetWorkerThreads(options.workers)
+        .SetPipelined(options.pipelined)
+        .SetRandomSeed(options.seed)
+        .SetProfileTracePath(options.trace);
+
+    Game::Run(setting, []() {
+        Game::LoadTextureAtlas({
+            AssetPath(AssetId::ENEMY),
+            AssetPath(AssetId::ENEMYBULLET),
+            AssetPath(AssetId::EXPLOSION),
+            AssetPath(AssetId::STAR1),
+            AssetPath(AssetId::STAR2),
+            AssetPath(AssetId::STAR3),
+            AssetPath(AssetId::STAR4),
+            AssetPath(AssetId::STAR5)
+        });
+
+        AddToGame( StressScene() );
+        AddToGame( FrameTimer() );
+    });
+
+    // Entity counts of the scene as it was when the benchmark stopped
+    auto& reg = Registry::Get();
+    const auto entities = countActive<PositionComponent>();
+    const auto scripts = countActive<ScriptComponent>();
+    const auto textures = countActive<TextureComponent>();
+    const auto colliders = countActive<CollisionMaskComponent>();
+    std::size_t particles = 0;
+    reg.view<const ParticleEmitterComponent>().each([&particles](const auto& emitter) {
+        particles += emitter.particles.GetSize();
+    });
+
+    std::vector<double> sorted = frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for(double frameTime : sorted) total += frameTime;
+    const double seconds = static_cast<double>(benchmarkEnd - benchmarkStart) / static_cast<double>(SDL_GetPerformanceFrequency());
+
+    std::cout << "{\n"
+        << "  \"scene\": { \"enemies\": " << options.enemies
+            << ", \"enemyBullets\": " << options.enemyBullets
+            << ", \"explosions\": " << options.explosions
+            << ", \"stars\": " << (options.stars ? "true" : "false") << " },\n"
+        << "  \"seed\": " << Game::GetRandomSeed() << ",\n"
+        << "  \"pipelined\": " << (options.pipelined ? "true" : "false") << ",\n"
+        << "  \"workers\": " << (options.workers >= 0 ? options.workers : std::max(SDL_GetCPUCount() - 1, 0)) << ",\n"
+        << "  \"ticks\": " << sorted.size() << ",\n"
+        << "  \"ticksPerSecond\": " << (seconds > 0.0 ? static_cast<double>(sorted.size()) / seconds : 0.0) << ",\n"
+        << "  \"" << (options.pipelined ? "tickTimeMs" : "frameTimeMs") << "\": { \"mean\": " << (sorted.empty() ? 0.0 : total / static_cast<double>(sorted.size()))
+            << ", \"p50\": " << percentile(sorted, 0.50)
+            << ", \"p90\": " << percentile(sorted, 0.90)
+            << ", \"p99\": " << percentile(sorted, 0.99)
+            << ", \"max\": " << (sorted.empty() ? 0.0 : sorted.back()) << " },\n"
+        << "  \"entities\": { \"positioned\": " << entities
+            << ", \"scripted\": " << scripts
+            << ", \"textured\": " << textures
+            << ", \"colliders\": " << colliders
+            << ", \"particles\": " << particles << " },\n"
+        << "  \"spritesPerFrame\": { \"drawn\": " << (sorted.empty() ? 0.0 : static_cast<double>(spritesDrawn) / static_cast<double>(sorted.size()))
+            << ", \"culled\": " << (sorted.empty() ? 0.0 : static_cast<double>(spritesCulled) / static_cast<double>(sorted.size())) << " }\n"
+        << "}" << std::endl;
+
+    return 0;
+}
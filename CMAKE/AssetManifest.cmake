@@ -0,0 +1,33 @@
+# Writes a header listing every png in GFX_DIR as an AssetId with its path,
+# so the game picks textures by index instead of by path string.
+#
+#   generate_asset_manifest(${CMAKE_SOURCE_DIR}/gfx ${CMAKE_BINARY_DIR}/generated/Assets.hpp)
+#
+# gfx/enemy bullet.png becomes AssetId::ENEMY_BULLET with path "gfx/enemy bullet.png".
+# The glob is checked on every build, adding or removing a png regenerates the header.
+function(generate_asset_manifest GFX_DIR OUTPUT)
+    file(GLOB ASSET_FILES CONFIGURE_DEPENDS "${GFX_DIR}/*.png")
+    list(SORT ASSET_FILES)
+    get_filename_component(GFX_NAME ${GFX_DIR} NAME)
+
+    set(ASSET_IDS "")
+    set(ASSET_PATHS "")
+    foreach(ASSET_FILE ${ASSET_FILES})
+        get_filename_component(ASSET_FILE_NAME ${ASSET_FILE} NAME)
+        get_filename_component(ASSET_STEM ${ASSET_FILE} NAME_WE)
+        string(TOUPPER ${ASSET_STEM} ASSET_ID)
+        string(MAKE_C_IDENTIFIER ${ASSET_ID} ASSET_ID)
+        string(APPEND ASSET_IDS "    ${ASSET_ID},\n")
+        string(APPEND ASSET_PATHS "    \"${GFX_NAME}/${ASSET_FILE_NAME}\",\n")
+    endforeach()
+
+    set(CONTENT "// Generated by CMAKE/AssetManifest.cmake from ${GFX_NAME}/, do not edit\n")
+    string(APPEND CONTENT "#pragma once\n#include <cstddef>\n\n")
+    string(APPEND CONTENT "enum class AssetId : std::size_t {\n${ASSET_IDS}};\n\n")
+    string(APPEND CONTENT "constexpr const char* ASSET_PATHS[] = {\n${ASSET_PATHS}};\n\n")
+    string(APPEND CONTENT "constexpr std::size_t ASSET_COUNT = sizeof(ASSET_PATHS) / sizeof(ASSET_PATHS[0]);\n\n")
+    string(APPEND CONTENT "constexpr const char* AssetPath(AssetId id) {\n    return ASSET_PATHS[static_cast<std::size_t>(id)];\n}\n")
+
+    # Only touch the header when it changes, so nothing rebuilds for nothing
+    file(CONFIGURE OUTPUT ${OUTPUT} CONTENT "${CONTENT}" @ONLY)
+endfunction()
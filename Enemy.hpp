@@ -21,11 +21,12 @@ class Enemy {
 
             // Shoot in direction of the player
             if(spawnTimeout <= 0.0f) {
-                auto player = Game::FindGameObject("player");
+                static GameObjectHandle player{ "player"_hs };
+                auto target = player.Get();
 
-                if(player.IsValid()) {
-                    const auto& playerPos = player.GetComponent<PositionComponent>();
-                    const auto& playerTex = player.GetComponent<TextureComponent>();
+                if(target.IsValid()) {
+                    const auto& playerPos = target.GetComponent<PositionComponent>();
+                    const auto& playerTex = target.GetComponent<TextureComponent>();
                     AddToGame(EnemyBullet(
                         position.x + texture.width / 2.0f,
                         position.y + texture.height / 2.0f,
@@ -42,14 +43,13 @@ class Enemy {
 
 public:
     void operator()() {
-        auto& self = GameObject()
+        auto self = GameObject()
             .AddComponent<SpaceShipRenderLayer>()
             .AddComponent<VelocityComponent>( -Game::GenerateRandom(ENEMY_MIN_SPEED, ENEMY_MAX_SPEED), 0.0f)
-            .AddComponent<TextureComponent>( Game::LoadTexture("gfx/enemy.png") )
+            .AddComponent<TextureComponent>( Game::GetTexture(AssetId::ENEMY) )
             .AddComponent<ScriptComponent>( EnemyScript() )
             .AddComponent<SpawnEnemyBulletTimeoutComponent>(Game::GenerateRandom(ENEMY_BULLET_SPAWN_TIMEOUT_MIN, ENEMY_BULLET_SPAWN_TIMEOUT_MAX))
-            .AddComponent<PlayerBulletColitionLayerTag>()
-            .AddComponent<EnemyColitionLayerTag>()
+            .AddComponent<CollisionMaskComponent>(ENEMY_COLLISION_LAYER)
             .AddComponent<AABBComponent>(20.0f, 0.0f, -20.0f, 0.0f, false);
         
         const auto& texture = self.GetComponent<TextureComponent>();
@@ -50,12 +50,12 @@ public:
             dx = dy = 0.0f;
         }
 
-        auto gameObject = GameObject()
+        auto gameObject = GameObject::FromPool<EnemyBullet>()
             .AddComponent<BulletRenderLayer>()
             .AddComponent<VelocityComponent>(dx * ENEMY_BULLET_SPEED, dy * ENEMY_BULLET_SPEED)
-            .AddComponent<TextureComponent>( Game::LoadTexture("gfx/enemybullet.png"))
+            .AddComponent<TextureComponent>( Game::GetTexture(AssetId::ENEMYBULLET))
             .AddComponent<ScriptComponent>( EnemyBulletScript() )
-            .AddComponent<EnemyBulletColitionLayerTag>()
+            .AddComponent<CollisionMaskComponent>(ENEMY_BULLET_COLLISION_LAYER)
             .AddComponent<AABBComponent>(0.0f, 0.0f, 0.0f, 0.0f, false);
         
         const auto& tex = gameObject.GetComponent<TextureComponent>();
@@ -3,67 +3,46 @@
 #include "GameEngine/GameEngine.hpp"
 #include "GameEngine/Game.hpp"
 
+// Bursts count explosion particles around (x, y). All explosions share one
+// particle emitter, it is created with the first explosion of a scene.
 class Explosion {
     float m_x, m_y;
-
-    struct TimeoutToDestroy {
-        float timeout;
-    };
-
-    struct ExplisionScript: Script {
-        void OnUpdate(GameObject& self, float dt) {
-            auto& timeout = self.GetComponent<TimeoutToDestroy>().timeout;
-            auto& alpha = self.GetComponent<AddBlenderComponent>().a;
-
-            if(timeout <= 0.0f) {
-                self.Destroy();
-            }
-
-            timeout -= dt;
-
-            // Decrease the alpha value to fade it away.
-            alpha -= 255 * 0.7 * dt;
+    int m_count;
+
+    static ParticleEmitterComponent& emitter() {
+        static GameObjectHandle handle{ "explosions"_hs };
+        auto emitter = handle.Get();
+        if(!emitter.IsValid()) {
+            emitter = GameObject()
+                .AddComponent<SearchableComponent>("explosions"_hs)
+                .AddComponent<BulletRenderLayer>()
+                .AddComponent<ParticleEmitterComponent>(Game::GetTexture(AssetId::EXPLOSION), SDL_BLENDMODE_ADD, 255.0f * 0.7f);
         }
-    };
+        return emitter.GetComponent<ParticleEmitterComponent>();
+    }
 
 public:
-    Explosion(float x, float y): m_x(x), m_y(y) { }
+    Explosion(float x, float y, int count = 1): m_x(x), m_y(y), m_count(count) { }
 
     void operator()() {
-        auto explosion = GameObject()
-            .AddComponent<BulletRenderLayer>()
-            .AddComponent<PositionComponent>(m_x + Game::GenerateRandom(-32.0f, 32.0f), m_y + Game::GenerateRandom(-32.0f, 32.0f))
-            .AddComponent<VelocityComponent>(Game::GenerateRandom(-100.0f, 100.0f), Game::GenerateRandom(-100.0f, 100.0f))
-            .AddComponent<TextureComponent>(Game::LoadTexture("gfx/explosion.png"))
-            .AddComponent<TimeoutToDestroy>(0.7f)
-            .AddComponent<ScriptComponent>(ExplisionScript());
-            
-            // Randomize a color for the explostion
-            auto randomNumber  = Game::GenerateRandom(1.0f, 5.0f);
-            uint8_t r,g,b,a;
-            if(randomNumber > 1.0f && randomNumber <= 2.0f) {
-                r = 255;
-                g = 0;
-                b = 0;
-            }
-            else if(randomNumber > 2.0f && randomNumber <= 3.0f) {
-                r = 255;
-                g = 128;
-                b = 0;
-
-            }
-            else if(randomNumber > 3.0f && randomNumber <= 4.0f) {
-                r = 255;
-                g = 255;
-                b = 0;
-
-            }
-            else {
-                r = 255;
-                g = 255;
-                b = 255;
-            }
-            a = static_cast<uint8_t>(Game::GenerateRandom(128.0f, 255.0f));
-            explosion.AddComponent<AddBlenderComponent>(r, g, b, a);
+        static const SDL_Color colors[] = {
+            { 255, 0, 0, 255 }, { 255, 128, 0, 255 }, { 255, 255, 0, 255 }, { 255, 255, 255, 255 }
+        };
+
+        if(m_count <= 0) return;
+        auto& particles = emitter().particles;
+
+        // The whole burst is randomized one attribute at a time
+        auto& random = Game::GetRandom();
+        const auto count = static_cast<std::size_t>(m_count);
+        const auto first = particles.Grow(count, 0.7f);
+        random.Fill(&particles.x[first], count, m_x - 32.0f, m_x + 32.0f);
+        random.Fill(&particles.y[first], count, m_y - 32.0f, m_y + 32.0f);
+        random.Fill(&particles.dx[first], count, -100.0f, 100.0f);
+        random.Fill(&particles.dy[first], count, -100.0f, 100.0f);
+        random.Fill(&particles.alpha[first], count, 128.0f, 255.0f);
+        for(std::size_t i = first; i < first + count; i++) {
+            particles.color[i] = colors[random.Below(4)];
+        }
     }
 };
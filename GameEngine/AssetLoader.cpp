@@ -0,0 +1,75 @@
+#include <SDL_image.h>
+#include <algorithm>
+#include <iostream>
+#include "AssetLoader.hpp"
+
+AssetLoader::~AssetLoader()
+{
+    Cancel();
+}
+
+void AssetLoader::Start(const std::vector<std::string>& paths, int threads)
+{
+    Cancel();
+    m_paths = paths;
+    m_surfaces.assign(paths.size(), nullptr);
+    m_ready = std::make_unique<std::atomic<bool>[]>(paths.size());
+    for(std::size_t i = 0; i < paths.size(); i++) {
+        m_ready[i] = false;
+    }
+    m_next = 0;
+    m_loaded = 0;
+    m_cancel = false;
+
+    // The decoders are set up here once, the threads would race doing it on first use
+    IMG_Init(IMG_INIT_PNG);
+
+    const std::size_t count = std::min<std::size_t>(static_cast<std::size_t>(std::max(threads, 1)), paths.size());
+    for(std::size_t i = 0; i < count; i++) {
+        m_threads.emplace_back(&AssetLoader::decode, this);
+    }
+}
+
+void AssetLoader::decode()
+{
+    while(!m_cancel.load(std::memory_order_relaxed)) {
+        const std::size_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+        if(index >= m_paths.size()) return;
+
+        SDL_Surface* surface = IMG_Load(m_paths[index].c_str());
+        if(surface == nullptr) {
+            // SDL errors are per thread, read it here
+            std::cerr << "Failed to load " + m_paths[index] + ": " + IMG_GetError() + "\n";
+        }
+        m_surfaces[index] = surface;
+        m_ready[index].store(true, std::memory_order_release);
+        m_loaded.fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+void AssetLoader::Cancel()
+{
+    m_cancel = true;
+    for(auto& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+    for(auto* surface : m_surfaces) {
+        SDL_FreeSurface(surface);
+    }
+    m_surfaces.clear();
+    m_paths.clear();
+    m_ready.reset();
+}
+
+std::vector<SDL_Surface*> AssetLoader::Take()
+{
+    for(auto& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+    std::vector<SDL_Surface*> surfaces;
+    surfaces.swap(m_surfaces);
+    Cancel();
+    return surfaces;
+}
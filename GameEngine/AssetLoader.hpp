@@ -0,0 +1,67 @@
+#pragma once
+#include <SDL.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Decodes images to surfaces on threads of its own while the game keeps
+// running. Textures can only be made on the render thread, that happens after
+// Take. An image is known by its index in the paths, with the generated
+// ASSET_PATHS the index is the AssetId.
+class AssetLoader {
+    std::vector<std::string> m_paths;
+    std::vector<SDL_Surface*> m_surfaces;
+    std::unique_ptr<std::atomic<bool>[]> m_ready;
+    std::vector<std::thread> m_threads;
+    std::atomic<std::size_t> m_next{ 0 };
+    std::atomic<std::size_t> m_loaded{ 0 };
+    std::atomic<bool> m_cancel{ false };
+
+    void decode();
+
+public:
+    AssetLoader() = default;
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+    ~AssetLoader();
+
+    // Start decoding on up to threads threads, at least one
+    void Start(const std::vector<std::string>& paths, int threads);
+
+    // Stop decoding and free what was decoded but not taken
+    void Cancel();
+
+    // Wait for the rest and hand over the surfaces in the order of the paths,
+    // nullptr for images that failed. The caller frees them.
+    std::vector<SDL_Surface*> Take();
+
+    // True between Start and Take or Cancel
+    bool IsActive() const {
+        return !m_paths.empty();
+    }
+
+    // Decoded or failed, either way done with. False outside of Start and Take.
+    bool IsReady(std::size_t index) const {
+        if(!IsActive() || index >= GetCount()) return false;
+        return m_ready[index].load(std::memory_order_acquire);
+    }
+
+    bool IsDone() const {
+        return GetLoaded() == GetCount();
+    }
+
+    std::size_t GetLoaded() const {
+        return m_loaded.load(std::memory_order_acquire);
+    }
+
+    std::size_t GetCount() const {
+        return m_paths.size();
+    }
+
+    const std::vector<std::string>& GetPaths() const {
+        return m_paths;
+    }
+};
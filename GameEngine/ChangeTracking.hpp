@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <entity/registry.hpp>
+#include "PooledComponent.hpp"
+
+// Put on an entity when its T was added, replaced or patched, with the tick
+// it happened in. Only for types tracked with ChangeTracking::Track<T>.
+template<typename T>
+struct Changed {
+    std::uint64_t tick;
+};
+
+// Change detection on top of EnTT's construct and update signals. Writes that
+// should count go through AddComponent or PatchComponent, a plain GetComponent
+// write goes unnoticed. Changes are kept for two ticks, so a script sees what
+// changed since the start of the previous tick no matter when it runs.
+class ChangeTracking {
+    using Prune = void (*)(entt::registry&, std::uint64_t);
+
+    static std::uint64_t& tick() {
+        static std::uint64_t current = 0;
+        return current;
+    }
+
+    static std::vector<Prune>& prunes() {
+        static std::vector<Prune> list;
+        return list;
+    }
+
+    template<typename T>
+    static void onChanged(entt::registry& reg, entt::entity entity) {
+        reg.emplace_or_replace<Changed<T>>(entity, tick());
+    }
+
+    template<typename T>
+    static void prune(entt::registry& reg, std::uint64_t oldest) {
+        // Kept between ticks, so pruning doesn't allocate once it has grown
+        static std::vector<entt::entity> stale;
+        stale.clear();
+        auto& changes = reg.storage<Changed<T>>();
+        for(auto entity : changes) {
+            if(changes.get(entity).tick < oldest) stale.push_back(entity);
+        }
+        reg.remove<Changed<T>>(stale.begin(), stale.end());
+    }
+
+public:
+    // Start marking changes of T, once per type is enough
+    template<typename T>
+    static void Track(entt::registry& reg) {
+        static bool tracked = false;
+        if(tracked) return;
+        tracked = true;
+        reg.on_construct<T>().template connect<&onChanged<T>>();
+        reg.on_update<T>().template connect<&onChanged<T>>();
+        prunes().push_back(&prune<T>);
+    }
+
+    // Called by the game at the start of every tick
+    static void NextTick(entt::registry& reg) {
+        const std::uint64_t current = ++tick();
+        for(auto pruneChanges : prunes()) {
+            pruneChanges(reg, current - 1);
+        }
+    }
+
+    static std::uint64_t GetTick() {
+        return tick();
+    }
+
+    template<typename T>
+    static bool HasChanged(entt::registry& reg, entt::entity entity) {
+        return reg.all_of<Changed<T>>(entity);
+    }
+
+    // Call func(entity, T&) for every enabled T changed since the start of the previous tick
+    template<typename T, typename Func>
+    static void EachChanged(entt::registry& reg, Func func) {
+        reg.view<T, const Changed<T>>(entt::exclude<DisabledTag>).each([&func](entt::entity entity, T& component, const Changed<T>&) {
+            func(entity, component);
+        });
+    }
+};
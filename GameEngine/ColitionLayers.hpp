@@ -1,10 +0,0 @@
-#pragma once
-
-struct ColitionLayer1Tag { };
-struct ColitionLayer2Tag { };
-struct ColitionLayer3Tag { };
-struct ColitionLayer4Tag { };
-struct ColitionLayer5Tag { };
-struct ColitionLayer6Tag { };
-struct ColitionLayer7Tag { };
-struct ColitionLayer8Tag { };
@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+// Collision layers are bits, so an entity can be in any of 32 layers at once
+struct CollisionMaskComponent {
+    std::uint32_t category;      // Layers the entity belongs to
+    std::uint32_t collidesWith;  // Extra layers to get OnCollision for, on top of the Setting matrix
+};
+
+// Test the collider with swept AABB over the whole tick instead of only at its end position
+struct ContinuousCollisionTag { };
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "CommandBuffer.hpp"
+#include "PooledComponent.hpp"
+
+namespace {
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<CommandBuffer>> buffers;
+    std::thread::id mainThread = std::this_thread::get_id();
+
+    // Placeholders count down from the highest entity below entt::null. Their
+    // version is 0, the registry hands out such an entity only once it holds
+    // almost a million of them.
+    std::atomic<std::uint32_t> placeholders(0);
+    std::vector<entt::entity> resolved;
+
+    std::uint32_t firstPlaceholder() {
+        return entt::to_entity(static_cast<entt::entity>(entt::null)) - 1u;
+    }
+
+    // Reused between sync points
+    std::vector<std::function<void(entt::registry&)>> commands;
+    std::vector<entt::entity> destroys;
+    std::vector<entt::entity> plainDestroys;
+}
+
+CommandBuffer& CommandBuffer::Get()
+{
+    thread_local CommandBuffer* buffer = nullptr;
+    if(buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers.push_back(std::make_unique<CommandBuffer>());
+        buffer = buffers.back().get();
+    }
+    return *buffer;
+}
+
+bool CommandBuffer::IsMainThread()
+{
+    return std::this_thread::get_id() == mainThread;
+}
+
+void CommandBuffer::SetMainThread()
+{
+    mainThread = std::this_thread::get_id();
+}
+
+entt::entity CommandBuffer::Create()
+{
+    const std::uint32_t placeholder = placeholders.fetch_add(1, std::memory_order_relaxed);
+    assert(placeholder < MAX_PLACEHOLDERS && "Too many entities created off the main thread in one tick");
+    const auto entity = static_cast<entt::entity>(firstPlaceholder() - placeholder);
+    m_creates.push_back(entity);
+    return entity;
+}
+
+entt::entity CommandBuffer::Resolve(entt::entity entity)
+{
+    if(entt::to_version(entity) != 0) return entity;
+    const std::uint32_t first = firstPlaceholder();
+    const std::uint32_t index = entt::to_entity(entity);
+    if(index > first || first - index >= resolved.size()) return entity;
+    return resolved[first - index];
+}
+
+void CommandBuffer::ApplyAll(entt::registry& reg)
+{
+    // Commands record into the main thread buffer, it has to exist before locking
+    Get();
+    std::lock_guard<std::mutex> lock(buffersMutex);
+
+    // Applying may record more, for example a prefab destroying an entity or an
+    // OnDestroyed destroying another one, so repeat until all buffers are empty
+    for(;;) {
+        commands.clear();
+        destroys.clear();
+        bool created = false;
+
+        // Entities first, the commands and destroys of any thread may use their placeholders
+        for(auto& buffer : buffers) {
+            for(auto placeholder : buffer->m_creates) {
+                const std::uint32_t index = firstPlaceholder() - entt::to_entity(placeholder);
+                if(resolved.size() <= index) resolved.resize(index + 1, entt::null);
+                resolved[index] = reg.create();
+            }
+            created = created || !buffer->m_creates.empty();
+            buffer->m_creates.clear();
+        }
+        for(auto& buffer : buffers) {
+            std::move(buffer->m_commands.begin(), buffer->m_commands.end(), std::back_inserter(commands));
+            buffer->m_commands.clear();
+            for(auto entity : buffer->m_destroys) {
+                destroys.push_back(Resolve(entity));
+            }
+            buffer->m_destroys.clear();
+        }
+        if(!created && commands.empty() && destroys.empty()) break;
+
+        for(auto& command : commands) {
+            command(reg);
+        }
+
+        // An entity may be destroyed more than once, or be gone already after a scene reset
+        std::sort(destroys.begin(), destroys.end());
+        destroys.erase(std::unique(destroys.begin(), destroys.end()), destroys.end());
+
+        plainDestroys.clear();
+        for(auto entity : destroys) {
+            if(!reg.valid(entity) || reg.all_of<ParkingTag>(entity)) continue;
+            if(reg.all_of<PooledComponent>(entity)) {
+                // Pooled entities are parked, they return to the pool when the next tick starts
+                if(!reg.all_of<DisabledTag>(entity)) reg.emplace<DisabledTag>(entity);
+                reg.emplace<ParkingTag>(entity);
+            }
+            else {
+                plainDestroys.push_back(entity);
+            }
+        }
+        reg.destroy(plainDestroys.begin(), plainDestroys.end());
+    }
+
+    resolved.clear();
+    placeholders = 0;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <entt.hpp>
+
+// Structural changes recorded during a tick and applied at the sync points of
+// Game::Run, when no view is being iterated. Every thread records into its own
+// buffer.
+//
+// Destroys always go through the buffer and are applied as one batch. On the
+// main thread GameObject::Destroy disables the entity right away, so it is
+// skipped by the engine and IsValid() is false until it is gone.
+//
+// Off the main thread the registry must not be changed at all. There
+// GameObject's constructor, AddComponent, PatchComponent, RemoveComponent and
+// Destroy as well as AddToGame record into the buffer. A GameObject created
+// this way holds a placeholder entity, the real one is created at the next
+// sync point and the commands recorded for the placeholder are applied to it.
+// Components added this way can't be read before the next sync point, and a
+// placeholder must not be kept past it.
+//
+// On the main thread only destroys and scene resets are deferred. Adding and
+// removing components or creating entities happens right away, also while the
+// engine dispatches OnUpdate, OnEvent and OnCollision, so that dispatch walks
+// the pools by index and tolerates them changing.
+class CommandBuffer {
+    std::vector<std::function<void(entt::registry&)>> m_commands;
+    std::vector<entt::entity> m_creates;
+    std::vector<entt::entity> m_destroys;
+
+public:
+    // The buffer of the calling thread
+    static CommandBuffer& Get();
+
+    // True on the thread that runs the game loop
+    static bool IsMainThread();
+
+    // Make the calling thread the main thread, Game::Run does this
+    static void SetMainThread();
+
+    // Apply the commands of all threads in the order they were recorded per
+    // thread, then the destroys. Only call it from the main thread while no
+    // other thread records.
+    static void ApplyAll(entt::registry& reg);
+
+    void Record(std::function<void(entt::registry&)> command) {
+        m_commands.push_back(std::move(command));
+    }
+
+    // A placeholder for an entity created at the next sync point, there are
+    // at most MAX_PLACEHOLDERS per sync point
+    entt::entity Create();
+
+    void Destroy(entt::entity entity) {
+        m_destroys.push_back(entity);
+    }
+
+    // The entity created for a placeholder while the commands are applied, any
+    // other entity as it is
+    static entt::entity Resolve(entt::entity entity);
+
+    bool IsEmpty() const {
+        return m_commands.empty() && m_creates.empty() && m_destroys.empty();
+    }
+
+    static constexpr std::uint32_t MAX_PLACEHOLDERS = 1u << 16;
+};
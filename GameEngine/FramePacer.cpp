@@ -0,0 +1,105 @@
+#include <algorithm>
+#include "FramePacer.hpp"
+
+RollingHistogram::RollingHistogram(std::size_t buckets, std::size_t window)
+    : m_counts(std::max<std::size_t>(buckets, 1), 0)
+    , m_samples(std::max<std::size_t>(window, 1), 0)
+{
+}
+
+void RollingHistogram::Add(std::size_t bucket)
+{
+    bucket = std::min(bucket, m_counts.size() - 1);
+    if(m_size == m_samples.size()) {
+        m_counts[m_samples[m_next]]--;
+    }
+    else {
+        m_size++;
+    }
+    m_samples[m_next] = bucket;
+    m_counts[bucket]++;
+    m_next = (m_next + 1) % m_samples.size();
+}
+
+void RollingHistogram::Clear()
+{
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_next = 0;
+    m_size = 0;
+}
+
+std::size_t RollingHistogram::Percentile(double p) const
+{
+    const double wanted = p * static_cast<double>(m_size);
+    std::size_t seen = 0;
+    for(std::size_t bucket = 0; bucket < m_counts.size(); bucket++) {
+        seen += m_counts[bucket];
+        if(m_size > 0 && static_cast<double>(seen) >= wanted) return bucket;
+    }
+    return m_counts.size() - 1;
+}
+
+FramePacer::FramePacer()
+    : m_frameTimes(FRAME_TIME_BUCKETS, WINDOW)
+    , m_ticksPerFrame(1, WINDOW)
+{
+}
+
+void FramePacer::Reset(float secondPerFrame, int maxCatchUpTicks, int frameRateLimit, bool fixedStep)
+{
+    m_frequency = SDL_GetPerformanceFrequency();
+    m_tick = std::max<Uint64>(static_cast<Uint64>(static_cast<double>(secondPerFrame) * static_cast<double>(m_frequency)), 1);
+    m_frameLimit = frameRateLimit > 0 ? m_frequency / static_cast<Uint64>(frameRateLimit) : 0;
+    m_maxCatchUpTicks = std::max(maxCatchUpTicks, 1);
+    m_fixedStep = fixedStep;
+    m_lag = 0;
+    m_droppedTicks = 0;
+    m_frameTimes.Clear();
+    m_ticksPerFrame = RollingHistogram(static_cast<std::size_t>(m_maxCatchUpTicks) + 1, WINDOW);
+    m_previous = SDL_GetPerformanceCounter();
+}
+
+int FramePacer::BeginFrame()
+{
+    const Uint64 now = SDL_GetPerformanceCounter();
+    const Uint64 elapsed = now - m_previous;
+    m_previous = now;
+    m_frameTimes.Add(static_cast<std::size_t>(elapsed * 1000 / m_frequency));
+
+    m_lag += m_fixedStep ? m_tick : elapsed;
+    Uint64 ticks = m_lag / m_tick;
+    m_lag -= ticks * m_tick;
+
+    // After a stall run the allowed ticks and let the game slow down for the rest
+    if(ticks > static_cast<Uint64>(m_maxCatchUpTicks)) {
+        m_droppedTicks += ticks - static_cast<Uint64>(m_maxCatchUpTicks);
+        ticks = static_cast<Uint64>(m_maxCatchUpTicks);
+    }
+    m_ticksPerFrame.Add(static_cast<std::size_t>(ticks));
+    return static_cast<int>(ticks);
+}
+
+// SDL_Delay oversleeps by up to a millisecond or so, the last bit is waited out
+static void sleepUntil(Uint64 due, Uint64 frequency)
+{
+    const Uint64 now = SDL_GetPerformanceCounter();
+    if(now >= due) return;
+    const Uint64 ms = (due - now) * 1000 / frequency;
+    if(ms > 1) SDL_Delay(static_cast<Uint32>(ms - 1));
+    while(SDL_GetPerformanceCounter() < due) {}
+}
+
+void FramePacer::WaitForFrame() const
+{
+    if(m_frameLimit == 0 || m_fixedStep) return;
+    sleepUntil(m_previous + m_frameLimit, m_frequency);
+}
+
+// A tick starting a bit late only leaves more lag, no need to spin for it
+void FramePacer::WaitForTick() const
+{
+    if(m_fixedStep) return;
+    const Uint64 passed = m_lag + (SDL_GetPerformanceCounter() - m_previous);
+    if(passed >= m_tick) return;
+    SDL_Delay(static_cast<Uint32>(((m_tick - passed) * 1000 + m_frequency - 1) / m_frequency));
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Counts of the last samples per bucket, the oldest sample drops out when a
+// new one comes in.
+class RollingHistogram {
+    std::vector<std::uint32_t> m_counts;
+    std::vector<std::size_t> m_samples;
+    std::size_t m_next = 0;
+    std::size_t m_size = 0;
+
+public:
+    RollingHistogram(std::size_t buckets, std::size_t window);
+
+    // Count a sample in bucket, values past the last bucket go to the last one
+    void Add(std::size_t bucket);
+
+    void Clear();
+
+    std::size_t GetBucketCount() const {
+        return m_counts.size();
+    }
+
+    std::uint32_t GetCount(std::size_t bucket) const {
+        return m_counts[bucket];
+    }
+
+    // Samples currently counted, at most the window
+    std::size_t GetSize() const {
+        return m_size;
+    }
+
+    // Smallest bucket at or below which fraction p of the samples lie
+    std::size_t Percentile(double p) const;
+};
+
+// Paces the main loop on the performance counter. Decides how many fixed ticks
+// a frame runs, drops the rest after a stall so the game can't fall further and
+// further behind, and keeps rolling histograms of frame times and ticks.
+class FramePacer {
+    Uint64 m_frequency = 1;
+    Uint64 m_tick = 1;              // Counter ticks per fixed tick
+    Uint64 m_frameLimit = 0;        // Counter ticks per frame when limiting
+    Uint64 m_previous = 0;
+    Uint64 m_lag = 0;
+    int m_maxCatchUpTicks = 0;
+    bool m_fixedStep = false;
+    std::uint64_t m_droppedTicks = 0;
+    RollingHistogram m_frameTimes;
+    RollingHistogram m_ticksPerFrame;
+
+public:
+    // Frame times in buckets of one millisecond, the last one for everything longer
+    static constexpr std::size_t FRAME_TIME_BUCKETS = 64;
+    static constexpr std::size_t WINDOW = 256;
+
+    FramePacer();
+
+    // Start pacing now. With fixedStep every frame runs exactly one tick, no
+    // matter how long it took. A frameRateLimit of 0 doesn't limit.
+    void Reset(float secondPerFrame, int maxCatchUpTicks, int frameRateLimit, bool fixedStep);
+
+    // Measure the frame since the last call and return the ticks to run
+    int BeginFrame();
+
+    // Sleep until the frame rate limit allows the next frame
+    void WaitForFrame() const;
+
+    // Sleep until the next tick is due
+    void WaitForTick() const;
+
+    // Part of a tick passed but not simulated yet, between 0 and 1
+    float GetInterpolation() const {
+        return static_cast<float>(static_cast<double>(m_lag) / static_cast<double>(m_tick));
+    }
+
+    float GetLagMilliseconds() const {
+        return static_cast<float>(static_cast<double>(m_lag) * 1000.0 / static_cast<double>(m_frequency));
+    }
+
+    // Frame times of the last WINDOW frames, bucket i counts the ones taking i to i + 1 ms
+    const RollingHistogram& GetFrameTimes() const {
+        return m_frameTimes;
+    }
+
+    // Ticks run by each of the last WINDOW frames, up to the catch-up limit
+    const RollingHistogram& GetTicksPerFrame() const {
+        return m_ticksPerFrame;
+    }
+
+    // Ticks skipped since Reset because a frame would have run more than the limit
+    std::uint64_t GetDroppedTicks() const {
+        return m_droppedTicks;
+    }
+};
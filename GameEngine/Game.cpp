@@ -1,149 +1,394 @@
 #include <SDL.h>
 #include <SDL_image.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#endif
 #include "Game.hpp"
 
 SDL_Window *Game::m_window = nullptr;
 SDL_Renderer *Game::m_renderer = nullptr;
+std::thread::id Game::m_renderThread;
 std::unordered_map<std::string, SDL_Texture *> Game::m_textureCache = {};
-std::unordered_map<std::string, entt::entity> Game::m_searchableMap = {};
+entt::dense_map<entt::id_type, entt::entity, entt::identity> Game::m_searchableMap = {};
+std::uint32_t Game::m_searchableRevision = 0;
 float Game::m_secondPerFrame = 0.01;
-
-std::random_device Game::m_randomDevice;
-std::mt19937 Game::m_radomGenerator(Game::m_randomDevice());
-std::map<std::pair<float, float>, std::uniform_real_distribution<float>> Game::m_randomDistributions;
+std::atomic<bool> Game::m_quit(false);
+bool Game::m_maintenanceRequested = false;
+int Game::m_ticksSinceMaintenance = 0;
+SDL_FPoint Game::m_cameraOffset = { 0.0f, 0.0f };
+RenderStats Game::m_renderStats;
+RenderSnapshot Game::m_snapshot;
+FramePacer Game::m_pacer;
+SpatialGrid Game::m_collisionGrid;
+SpriteBatch Game::m_spriteBatch;
+SystemScheduler Game::m_systems;
+ParallaxCache Game::m_parallaxCache;
+
+Random Game::m_random;
+std::uint64_t Game::m_randomSeed = 0;
 
 std::unordered_map<std::string, TextureComponent> Game::m_textureRectCache;
-
+TextureAtlas Game::m_textureAtlas;
+std::array<TextureComponent, ASSET_COUNT> Game::m_assetTextures;
+AssetLoader Game::m_assetLoader;
+std::function<void(std::size_t, std::size_t)> Game::m_onLoadProgress;
+std::function<void(void)> Game::m_onAssetsLoaded;
+
+// Every script type has its own loop, see ScriptComponent. Scripts may use a
+// new script type for the first time, which adds a loop while we iterate.
 static void invokeCallOnEvent(entt::registry &reg, const SDL_Event &event)
 {
-    auto view = reg.view<ScriptComponent>();
-    view.each([&reg, &event](entt::entity entity, auto &script) {
-        auto gameObject = GameObject(reg, entity);
-        script.OnEvent(gameObject, event);
-    });
+    const auto& systems = ScriptComponent::GetEventSystems();
+    for(std::size_t i = 0; i < systems.size(); i++) {
+        systems[i](reg, event);
+    }
 }
 
 static void invokeCallOnUpdate(entt::registry &reg, float secondPerFrame)
 {
-    auto view = reg.view<ScriptComponent>();
-    view.each([&reg, secondPerFrame](entt::entity entity, auto &script) {
-        auto gameObject = GameObject(reg, entity);
-        script.OnUpdate(gameObject, secondPerFrame);
-    });
+    const auto& systems = ScriptComponent::GetUpdateSystems();
+    for(std::size_t i = 0; i < systems.size(); i++) {
+        systems[i](reg, secondPerFrame);
+    }
+}
+
+// Walks the velocity pool in chunks spread over the job system
+// Position and velocity are two packed floats each, so a page of either pool is a
+// plain float array and pos += vel * dt runs four floats at a time
+static_assert(sizeof(PositionComponent) == 2 * sizeof(float) && sizeof(VelocityComponent) == 2 * sizeof(float));
+
+static void integrate(float* pos, const float* vel, std::size_t count, float secondPerFrame)
+{
+    std::size_t i = 0;
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    const __m128 step = _mm_set1_ps(secondPerFrame);
+    for(; i + 4 <= count; i += 4) {
+        const __m128 p = _mm_loadu_ps(pos + i);
+        const __m128 v = _mm_loadu_ps(vel + i);
+        _mm_storeu_ps(pos + i, _mm_add_ps(p, _mm_mul_ps(v, step)));
+    }
+#endif
+    for(; i < count; i++) {
+        pos[i] += vel[i] * secondPerFrame;
+    }
 }
 
+// The owning group keeps every entity with both components at the front of the two
+// pools in the same order, so it is walked page by page with no lookups. Disabled
+// entities are moved too, they are not drawn and pooled ones get a new position.
 static void invokeMovement(entt::registry &reg, float secondPerFrame)
 {
-    auto view = reg.view<PositionComponent, const VelocityComponent>();
-    view.each([secondPerFrame](auto &pos, const auto &vel) {
-        pos.x += vel.dx * secondPerFrame;
-        pos.y += vel.dy * secondPerFrame;
+    constexpr std::size_t pageSize = entt::component_traits<PositionComponent>::page_size;
+    static_assert(pageSize == entt::component_traits<VelocityComponent>::page_size);
+
+    auto group = reg.group<PositionComponent, VelocityComponent>();
+    const std::size_t size = group.size();
+    PositionComponent* const* positions = group.storage<PositionComponent>().raw();
+    const VelocityComponent* const* velocities = group.storage<VelocityComponent>().raw();
+
+    JobSystem::ParallelFor((size + pageSize - 1) / pageSize, 1, [=](std::size_t begin, std::size_t end) {
+        for(std::size_t page = begin; page < end; page++) {
+            const std::size_t count = std::min(pageSize, size - page * pageSize);
+            integrate(&positions[page]->x, &velocities[page]->dx, count * 2, secondPerFrame);
+        }
     });
 }
 
-template<typename RenderLayerTag>
-static void invokeDrawTexture(entt::registry &reg, SDL_Renderer* renderer, float secondPerFrame, float interpolation)
-{
-    auto view = reg.view<RenderLayerTag, const PositionComponent, const TextureComponent>();
-    view.each([&reg, secondPerFrame, &renderer, interpolation](entt::entity entity, const auto &pos, const auto &tex) {
-        if(reg.any_of<AddBlenderComponent>(entity)) return;
-        if(reg.any_of<VelocityComponent>(entity)) {
-            auto& vel = reg.get<VelocityComponent>(entity);
-            SDL_Rect dst = {
-                static_cast<int>(pos.x + vel.dx * secondPerFrame * interpolation + 0.5f),
-                static_cast<int>(pos.y + vel.dy * secondPerFrame * interpolation + 0.5f),
-                static_cast<int>(tex.width), static_cast<int>(tex.height)
-            };
-            SDL_RenderCopy(renderer, tex.texture, NULL, &dst);
-        }
-        else {
-            SDL_Rect dst = {
-                static_cast<int>(pos.x + 0.5f), static_cast<int>(pos.y + 0.5f),
-                static_cast<int>(tex.width), static_cast<int>(tex.height)
-            };
-            SDL_RenderCopy(renderer, tex.texture, NULL, &dst);
+template<typename Component>
+static void shrinkPool(entt::registry &reg)
+{
+    auto& pool = reg.storage<Component>();
+    if(pool.capacity() > 2 * pool.size()) pool.shrink_to_fit();
+}
+
+// Churn leaves the pools in spawn order. Sort textures by render layer and
+// texture, let the other hot pools follow so draw and collision walk memory
+// in order, and give back what a spike left behind. Position and velocity are
+// owned by the movement group, so the group is sorted instead of the pools.
+static void invokeMaintenance(entt::registry &reg)
+{
+    const std::array<const entt::sparse_set*, 8> layers = {
+        &reg.storage<RenderLayer1Tag>(), &reg.storage<RenderLayer2Tag>(), &reg.storage<RenderLayer3Tag>(), &reg.storage<RenderLayer4Tag>(),
+        &reg.storage<RenderLayer5Tag>(), &reg.storage<RenderLayer6Tag>(), &reg.storage<RenderLayer7Tag>(), &reg.storage<RenderLayer8Tag>()
+    };
+    const auto& textures = reg.storage<TextureComponent>();
+    const auto key = [&](entt::entity entity) {
+        std::size_t layer = 0;
+        while(layer < layers.size() && !layers[layer]->contains(entity)) layer++;
+        const SDL_Texture* texture = textures.contains(entity) ? textures.get(entity).texture : nullptr;
+        return std::make_pair(layer, texture);
+    };
+    const auto compare = [&](entt::entity lhs, entt::entity rhs) { return key(lhs) < key(rhs); };
+
+    reg.sort<TextureComponent>(compare);
+    reg.sort<AABBComponent, TextureComponent>();
+    reg.sort<CollisionMaskComponent, TextureComponent>();
+    reg.sort<RenderLayer1Tag, TextureComponent>();
+    reg.sort<RenderLayer2Tag, TextureComponent>();
+    reg.sort<RenderLayer3Tag, TextureComponent>();
+    reg.sort<RenderLayer4Tag, TextureComponent>();
+    reg.sort<RenderLayer5Tag, TextureComponent>();
+    reg.sort<RenderLayer6Tag, TextureComponent>();
+    reg.sort<RenderLayer7Tag, TextureComponent>();
+    reg.sort<RenderLayer8Tag, TextureComponent>();
+    reg.group<PositionComponent, VelocityComponent>().sort(compare);
+
+    shrinkPool<PositionComponent>(reg);
+    shrinkPool<VelocityComponent>(reg);
+    shrinkPool<TextureComponent>(reg);
+    shrinkPool<AABBComponent>(reg);
+    shrinkPool<CollisionMaskComponent>(reg);
+}
+
+static void invokeParallax(entt::registry &reg, float secondPerFrame)
+{
+    auto view = reg.view<ParallaxComponent>(entt::exclude<DisabledTag>);
+    view.each([secondPerFrame](auto &parallax) {
+        const float width = static_cast<float>(parallax.width);
+        for(auto& band : parallax.bands) {
+            band.offset = std::fmod(band.offset + band.speed * secondPerFrame, width);
+            if(band.offset > 0.0f) band.offset -= width;
         }
     });
 }
 
+// Large emitters are integrated in chunks spread over the job system
+static void invokeParticles(entt::registry &reg, float secondPerFrame)
+{
+    auto view = reg.view<ParticleEmitterComponent>(entt::exclude<DisabledTag>);
+    view.each([secondPerFrame](auto &emitter) {
+        auto& particles = emitter.particles;
+        JobSystem::ParallelFor(particles.GetSize(), 8192, [&particles, &emitter, secondPerFrame](std::size_t begin, std::size_t end) {
+            particles.Integrate(begin, end, secondPerFrame, emitter.fadeRate);
+        });
+        particles.RemoveDead();
+    });
+}
+
+// Sync point, structural changes recorded by scripts are applied here
+static void applyCommands(entt::registry &reg)
+{
+    PROFILE_ZONE("Commands");
+    CommandBuffer::ApplyAll(reg);
+}
+
+// Entities of prefab pools destroyed during the last tick become reusable. Doing
+// it here and not in Destroy keeps a despawned entity from being respawned
+// while collision pairs of the same tick may still refer to it.
+static void invokeReleaseParked(entt::registry &reg)
+{
+    auto view = reg.view<ParkingTag, const PooledComponent>();
+    view.each([&reg](entt::entity entity, const auto &pooled) {
+        pooled.release(reg, entity);
+    });
+    reg.clear<ParkingTag>();
+}
+
+// Copy what one layer draws out of the registry, in draw order
 template<typename RenderLayerTag>
-static void invokeDrawAddBlendTexture(entt::registry &reg, SDL_Renderer* renderer, float secondPerFrame, float interpolation)
+static void snapshotLayer(entt::registry &reg, RenderSnapshot::Layer& layer)
 {
-    auto view = reg.view<RenderLayerTag, const PositionComponent, const TextureComponent, AddBlenderComponent>();
-    
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_ADD);
-    
-    view.each([&reg, secondPerFrame, &renderer, interpolation](entt::entity entity, const auto &pos, const auto &tex, auto& addBlender) {
-        SDL_SetTextureBlendMode(tex.texture, SDL_BLENDMODE_ADD);
-        SDL_SetTextureColorMod(tex.texture, addBlender.r, addBlender.g, addBlender.b);
-        SDL_SetTextureAlphaMod(tex.texture, addBlender.a);
-
-        if(reg.any_of<VelocityComponent>(entity)) {
-            auto& vel = reg.get<VelocityComponent>(entity);
-            SDL_Rect dst = {
-                static_cast<int>(pos.x + vel.dx * secondPerFrame * interpolation + 0.5f),
-                static_cast<int>(pos.y + vel.dy * secondPerFrame * interpolation + 0.5f),
-                static_cast<int>(tex.width), static_cast<int>(tex.height)
-            };
-            SDL_RenderCopy(renderer, tex.texture, NULL, &dst);
+    layer.parallax.clear();
+    layer.parallaxBands.clear();
+    layer.sprites.clear();
+
+    // Parallax backgrounds below the sprites, the renderer knows them already
+    // and only needs where the bands are now
+    auto parallaxView = reg.view<RenderLayerTag, const ParallaxComponent>(entt::exclude<DisabledTag>);
+    parallaxView.each([&layer](entt::entity entity, const auto &parallax) {
+        layer.parallax.push_back(RenderSnapshot::Parallax{ entity, layer.parallaxBands.size(), parallax.bands.size() });
+        for(const auto& band : parallax.bands) {
+            layer.parallaxBands.push_back(RenderSnapshot::ParallaxBand{ band.offset, band.speed, band.color });
         }
-        else {
-            SDL_Rect dst = {
-                static_cast<int>(pos.x + 0.5f), static_cast<int>(pos.y + 0.5f),
-                static_cast<int>(tex.width), static_cast<int>(tex.height)
-            };
-            SDL_RenderCopy(renderer, tex.texture, NULL, &dst);
+    });
+
+    const auto sprite = [&reg](entt::entity entity, const PositionComponent& pos, const TextureComponent& tex, SDL_BlendMode blendMode, SDL_Color color) {
+        const auto* vel = reg.try_get<VelocityComponent>(entity);
+        return RenderSnapshot::Sprite{ tex.texture, tex.source, blendMode, color,
+            pos.x, pos.y, vel ? vel->dx : 0.0f, vel ? vel->dy : 0.0f, tex.width, tex.height };
+    };
+
+    // Additive sprites first, then the ordinary ones on top
+    auto addBlendView = reg.view<RenderLayerTag, const PositionComponent, const TextureComponent, const AddBlenderComponent>(entt::exclude<DisabledTag>);
+    addBlendView.each([&layer, &sprite](entt::entity entity, const auto &pos, const auto &tex, const auto& addBlender) {
+        layer.sprites.push_back(sprite(entity, pos, tex, SDL_BLENDMODE_ADD, SDL_Color{ addBlender.r, addBlender.g, addBlender.b, addBlender.a }));
+    });
+
+    // Particles share the texture of their emitter and end up in the same batch
+    auto particleView = reg.view<RenderLayerTag, const ParticleEmitterComponent>(entt::exclude<DisabledTag>);
+    particleView.each([&layer](const auto &emitter) {
+        const auto& particles = emitter.particles;
+        const auto& tex = emitter.texture;
+        for(std::size_t i = 0; i < particles.GetSize(); i++) {
+            const auto& color = particles.color[i];
+            layer.sprites.push_back(RenderSnapshot::Sprite{ tex.texture, tex.source, emitter.blendMode,
+                SDL_Color{ color.r, color.g, color.b, static_cast<Uint8>(particles.alpha[i]) },
+                particles.x[i], particles.y[i], particles.dx[i], particles.dy[i], tex.width, tex.height });
         }
+    });
 
-        SDL_SetTextureColorMod(tex.texture, 255, 255, 255);
-        SDL_SetTextureAlphaMod(tex.texture, 255);
-        SDL_SetTextureBlendMode(tex.texture, SDL_BLENDMODE_BLEND);
+    auto view = reg.view<RenderLayerTag, const PositionComponent, const TextureComponent>(entt::exclude<AddBlenderComponent, DisabledTag>);
+    view.each([&layer, &sprite](entt::entity entity, const auto &pos, const auto &tex) {
+        layer.sprites.push_back(sprite(entity, pos, tex, SDL_BLENDMODE_BLEND, SDL_Color{ 255, 255, 255, 255 }));
     });
+}
 
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+static void takeSnapshot(entt::registry &reg, RenderSnapshot& snapshot, SDL_FPoint cameraOffset)
+{
+    PROFILE_ZONE("Snapshot");
+    snapshotLayer<RenderLayer1Tag>(reg, snapshot.layers[0]);
+    snapshotLayer<RenderLayer2Tag>(reg, snapshot.layers[1]);
+    snapshotLayer<RenderLayer3Tag>(reg, snapshot.layers[2]);
+    snapshotLayer<RenderLayer4Tag>(reg, snapshot.layers[3]);
+    snapshotLayer<RenderLayer5Tag>(reg, snapshot.layers[4]);
+    snapshotLayer<RenderLayer6Tag>(reg, snapshot.layers[5]);
+    snapshotLayer<RenderLayer7Tag>(reg, snapshot.layers[6]);
+    snapshotLayer<RenderLayer8Tag>(reg, snapshot.layers[7]);
+    snapshot.cameraOffset = cameraOffset;
 }
 
-template<typename ColitionLayerTag>
-static void invokeOnColition(entt::registry& reg, SDL_Renderer* renderer, float dt) {
-    auto view = reg.view<ColitionLayerTag, PositionComponent, TextureComponent, AABBComponent, VelocityComponent, ScriptComponent>();
-    auto otherView = reg.view<ColitionLayerTag, PositionComponent, TextureComponent, AABBComponent, VelocityComponent>();
-    for(entt::entity self : view) {
-        const auto& pos = reg.get<PositionComponent>(self);
-        const auto& tex = reg.get<TextureComponent>(self);
-        const auto& vel = reg.get<VelocityComponent>(self);
-        const auto& aabb = reg.get<AABBComponent>(self);
+// Move a world rect into the viewport, false when none of it is visible
+static bool toScreen(SDL_FRect& dst, const SDL_FRect& viewport, RenderStats& stats)
+{
+    if(dst.x + dst.w <= viewport.x || dst.x >= viewport.x + viewport.w || dst.y + dst.h <= viewport.y || dst.y >= viewport.y + viewport.h) {
+        stats.culled++;
+        return false;
+    }
+    dst.x -= viewport.x;
+    dst.y -= viewport.y;
+    stats.drawn++;
+    return true;
+}
+
+static void drawLayer(SDL_Renderer* renderer, SpriteBatch& batch, ParallaxCache& parallaxCache, const RenderSnapshot::Layer& layer, const SDL_FRect& viewport, RenderStats& stats, float t)
+{
+    // Each parallax strip is drawn twice to wrap around
+    for(const auto& entry : layer.parallax) {
+        const auto* cached = parallaxCache.Get(renderer, entry.entity);
+        if(!cached) continue;
+        const auto& parallax = cached->parallax;
+        const auto& strips = cached->strips;
+        const float width = static_cast<float>(parallax.width);
+        for(std::size_t i = 0; i < std::min(strips.size(), entry.bandCount); i++) {
+            const auto& band = layer.parallaxBands[entry.firstBand + i];
+            if(!strips[i]) continue;
+            SDL_SetTextureColorMod(strips[i], band.color.r, band.color.g, band.color.b);
+            SDL_SetTextureAlphaMod(strips[i], band.color.a);
+
+            float x = std::fmod(band.offset + band.speed * t, width);
+            if(x > 0.0f) x -= width;
+            x = static_cast<float>(static_cast<int>(x + 0.5f));
+            SDL_FRect dst = { x, 0.0f, width, static_cast<float>(parallax.height) };
+            SDL_RenderCopyF(renderer, strips[i], nullptr, &dst);
+            dst.x += width;
+            SDL_RenderCopyF(renderer, strips[i], nullptr, &dst);
+        }
+    }
+
+    for(const auto& sprite : layer.sprites) {
+        SDL_FRect dst = {
+            static_cast<float>(static_cast<int>(sprite.x + sprite.dx * t + 0.5f)),
+            static_cast<float>(static_cast<int>(sprite.y + sprite.dy * t + 0.5f)),
+            static_cast<float>(static_cast<int>(sprite.width)), static_cast<float>(static_cast<int>(sprite.height))
+        };
+        if(!toScreen(dst, viewport, stats)) continue;
+        batch.Draw(sprite.texture, sprite.source, sprite.blendMode, dst, sprite.color);
+    }
+
+    batch.Flush(renderer);
+}
+
+static SpatialGrid::Box colliderBox(const PositionComponent& pos, const TextureComponent& tex, const AABBComponent& aabb)
+{
+    return SpatialGrid::Box{
+        pos.x + aabb.left,
+        pos.y + aabb.top,
+        pos.x + tex.width + aabb.right,
+        pos.y + tex.height + aabb.bottom
+    };
+}
 
-        float ax1 = pos.x + vel.dx*dt + aabb.left;
-        float ay1 = pos.y + vel.dy*dt + aabb.top;
-        float ax2 = pos.x + tex.width + vel.dx*dt + aabb.right;
-        float ay2 = pos.y + tex.height + vel.dy*dt + aabb.bottom;
+static void dispatchCollision(entt::registry& reg, entt::entity self, entt::entity other)
+{
+    if(!reg.valid(self) || !reg.valid(other)) return;
+    if(reg.all_of<DisabledTag>(self) || reg.all_of<DisabledTag>(other)) return;
+    if(auto* script = reg.try_get<ScriptComponent>(self); script && script->HandlesCollision()) {
+        GameObject go = GameObject(reg, self);
+        GameObject otherGo = GameObject(reg, other);
+        script->OnCollision(go, otherGo);
+    }
+}
 
-        auto& script = reg.get<ScriptComponent>(self);
+static void invokeOnCollision(entt::registry& reg, std::vector<SDL_FRect>& colliderBoxes, SpatialGrid& grid, const Setting& setting, float dt) {
+    auto view = reg.view<const CollisionMaskComponent, const PositionComponent, const TextureComponent, const AABBComponent, const VelocityComponent>(entt::exclude<DisabledTag>);
+
+    // Broadphase, bucket every collider by the cells it covers
+    grid.Clear();
+    colliderBoxes.clear();
+    view.each([&reg, &grid, &colliderBoxes, &setting, dt](entt::entity entity, const auto& mask, const auto& pos, const auto& tex, const auto& aabb, const auto& vel) {
+        SpatialGrid::Item item;
+        item.entity = entity;
+        item.start = colliderBox(pos, tex, aabb);
+        item.dx = vel.dx * dt;
+        item.dy = vel.dy * dt;
+        item.box = item.start.Union(item.End());
+        item.category = mask.category;
+        item.collidesWith = mask.collidesWith | setting.GetCollidesWith(mask.category);
+        // Nobody listens for this side of the collision
+        if(auto* script = reg.try_get<ScriptComponent>(entity); !script || !script->HandlesCollision()) {
+            item.collidesWith = 0;
+        }
+        item.continuous = (mask.category & setting.GetContinuousCollision()) != 0 || reg.any_of<ContinuousCollisionTag>(entity);
+        grid.Insert(item);
 
         if(aabb.draw == true) {
-            auto rect = SDL_FRect{ ax1, ay1, ax2 - ax1, ay2  - ay1 };
-            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-            SDL_RenderDrawRectF(renderer, &rect);
+            const auto box = item.End();
+            colliderBoxes.push_back(SDL_FRect{ box.x1, box.y1, box.x2 - box.x1, box.y2 - box.y1 });
         }
+    });
 
-        for(entt::entity other : otherView) {
-            if(self == other) continue;
-            const auto& otherPos = reg.get<PositionComponent>(other);
-            const auto& otherTex = reg.get<TextureComponent>(other);
-            const auto& otherVel = reg.get<VelocityComponent>(other);
-            const auto& otherAabb = reg.get<AABBComponent>(other);
-
-            float bx1 = otherPos.x + otherVel.dx*dt + otherAabb.left;
-            float by1 = otherPos.y + otherVel.dy*dt + otherAabb.top;
-            float bx2 = otherPos.x + otherTex.width + otherVel.dx*dt + otherAabb.right;
-            float by2 = otherPos.y + otherTex.height + otherVel.dy*dt + otherAabb.bottom;
-
-            if((ax1 <= bx2 && ax2 >= bx1) && (ay1 <= by2 && ay2 >= by1)) {
-                GameObject go = GameObject(reg, self);
-                GameObject otherGo = GameObject(reg, other);
-                script.OnCollision(go, otherGo);                
-            }
+    // Narrowphase, visit every pair sharing a cell once and note each side that
+    // collides with the other's layers. Chunks of items are tested in parallel,
+    // the scripts are called afterwards on this thread in item order.
+    struct Contact {
+        entt::entity self, other;
+    };
+    constexpr std::size_t chunkSize = 256;
+    static std::vector<std::vector<Contact>> chunkContacts;
+
+    const auto count = grid.GetSize();
+    const auto chunks = (count + chunkSize - 1) / chunkSize;
+    if(chunkContacts.size() < chunks) chunkContacts.resize(chunks);
+
+    JobSystem::ParallelFor(count, chunkSize, [&grid](std::size_t begin, std::size_t end) {
+        auto& contacts = chunkContacts[begin / chunkSize];
+        contacts.clear();
+        for(std::size_t index = begin; index < end; index++) {
+            const auto& a = grid.GetItem(static_cast<std::uint32_t>(index));
+            grid.QueryConcurrent(a.box, [index, &a, &contacts](std::uint32_t otherIndex, const SpatialGrid::Item& b) {
+                if(otherIndex <= index) return;
+
+                const bool aCollides = (a.collidesWith & b.category) != 0;
+                const bool bCollides = (b.collidesWith & a.category) != 0;
+                if(!aCollides && !bCollides) return;
+                if(!a.Collides(b)) return;
+
+                if(aCollides) contacts.push_back(Contact{ a.entity, b.entity });
+                if(bCollides) contacts.push_back(Contact{ b.entity, a.entity });
+            });
+        }
+    });
+
+    for(std::size_t chunk = 0; chunk < chunks; chunk++) {
+        for(const auto& contact : chunkContacts[chunk]) {
+            dispatchCollision(reg, contact.self, contact.other);
         }
     }
 }
@@ -167,35 +412,332 @@ static void setupRenderer(SDL_Renderer* renderer,  const Setting& setting) {
     SDL_RenderSetLogicalSize(renderer, logicalSize.width, logicalSize.height);
 }
 
-void Game::onScriptComponentConstructed(entt::registry &reg, entt::entity entity)
+void Game::onScriptComponentDestroyed(entt::registry &reg, entt::entity entity)
+{
+    ScriptComponent::Detach(reg, entity);
+}
+
+// The strips belong to the renderer. It gets a copy of every new or changed
+// background with the next snapshot and drops the old strips before drawing it.
+void Game::onParallaxComponentConstructed(entt::registry& reg, entt::entity entity)
 {
-    auto gameObject = GameObject(reg, entity);
-    reg.get<ScriptComponent>(entity).OnConstructed(gameObject);
+    m_snapshot.definedParallax.emplace_back(entity, reg.get<ParallaxComponent>(entity));
 }
 
-void Game::onScriptComponentDestroyed(entt::registry &reg, entt::entity entity)
-{ 
-    auto gameObject = GameObject(reg, entity);
-    reg.get<ScriptComponent>(entity).OnDestroyed(gameObject);
+void Game::onParallaxComponentChanged(entt::registry& reg, entt::entity entity)
+{
+    auto& defined = m_snapshot.definedParallax;
+    defined.erase(std::remove_if(defined.begin(), defined.end(), [entity](const auto& entry) { return entry.first == entity; }), defined.end());
+    m_snapshot.releasedParallax.push_back(entity);
+}
+
+void Game::onParallaxComponentUpdated(entt::registry& reg, entt::entity entity)
+{
+    onParallaxComponentChanged(reg, entity);
+    onParallaxComponentConstructed(reg, entity);
 }
 
 void Game::onSearchableComponentConstructed(entt::registry& reg, entt::entity entity)
 {
     auto& searchableComponent = reg.get<SearchableComponent>(entity);
-    m_searchableMap.emplace(std::make_pair(searchableComponent.name, entity));
+    m_searchableMap.emplace(searchableComponent.id, entity);
+    m_searchableRevision++;
 }
 
 void Game::onSearchableComponentDestroyed(entt::registry& reg, entt::entity entity)
 {
     auto& searchableComponent = reg.get<SearchableComponent>(entity);
-    auto findResult = m_searchableMap.find(searchableComponent.name);
-    if(findResult != m_searchableMap.end()) {
+    auto findResult = m_searchableMap.find(searchableComponent.id);
+    if(findResult != m_searchableMap.end() && findResult->second == entity) {
         m_searchableMap.erase(findResult);
     }
+    m_searchableRevision++;
+}
+
+// The main thread has stream 0, the other threads streams from THREAD_STREAMS on
+Random& Game::GetRandom()
+{
+    if(CommandBuffer::IsMainThread()) return m_random;
+
+    thread_local Random random;
+    thread_local std::uint64_t seed = 0;
+    thread_local bool seeded = false;
+    if(!seeded || seed != m_randomSeed) {
+        seed = m_randomSeed;
+        seeded = true;
+        random.Seed(seed, THREAD_STREAMS + JobSystem::GetThreadIndex());
+    }
+    return random;
+}
+
+bool Game::handleEngineEvent(const SDL_Event& event, Setting& setting)
+{
+    if (event.type == SDL_QUIT) {
+        m_quit = true;
+    }
+    else if(event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+        setting.SetWindowSize(event.window.data1, event.window.data2);
+        setupRenderer(m_renderer, setting);
+    }
+    else if(event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+        // Render target content is gone, bake the parallax strips again
+        m_parallaxCache.DropStrips();
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+void Game::tick(entt::registry& reg, const Setting& setting)
+{
+    PROFILE_ZONE("Tick");
+    ChangeTracking::NextTick(reg);
+    if(m_maintenanceRequested || (setting.GetMaintenanceInterval() > 0 && ++m_ticksSinceMaintenance >= setting.GetMaintenanceInterval())) {
+        PROFILE_ZONE("Maintenance");
+        invokeMaintenance(reg);
+        m_maintenanceRequested = false;
+        m_ticksSinceMaintenance = 0;
+    }
+    invokeReleaseParked(reg);
+    {
+        PROFILE_ZONE("Update");
+        invokeCallOnUpdate(reg, m_secondPerFrame);
+    }
+    applyCommands(reg);
+    {
+        PROFILE_ZONE("Collision");
+        invokeOnCollision(reg, m_snapshot.colliderBoxes, m_collisionGrid, setting, m_secondPerFrame);
+    }
+    applyCommands(reg);
+    {
+        PROFILE_ZONE("Systems");
+        m_systems.Run(reg, m_secondPerFrame);
+    }
+    applyCommands(reg);
+}
+
+void Game::drawFrame(RenderSnapshot& snapshot, const Setting& setting, float interpolation, RenderStats& stats)
+{
+    static const char* const layerZones[] = {
+        "Draw layer 1", "Draw layer 2", "Draw layer 3", "Draw layer 4",
+        "Draw layer 5", "Draw layer 6", "Draw layer 7", "Draw layer 8"
+    };
+
+    for(auto entity : snapshot.releasedParallax) {
+        m_parallaxCache.Release(entity);
+    }
+    snapshot.releasedParallax.clear();
+    for(auto& entry : snapshot.definedParallax) {
+        m_parallaxCache.Define(entry.first, std::move(entry.second));
+    }
+    snapshot.definedParallax.clear();
+
+    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255); // Black
+    SDL_RenderClear(m_renderer);
+
+    // Sprites outside the logical screen at the camera are not submitted
+    const auto logicalSize = setting.GetLogicalSize();
+    const SDL_FRect viewport = { snapshot.cameraOffset.x, snapshot.cameraOffset.y, static_cast<float>(logicalSize.width), static_cast<float>(logicalSize.height) };
+
+    // Collider outlines of the last tick
+    SDL_SetRenderDrawColor(m_renderer, 255, 255, 255, 255);
+    for(auto rect : snapshot.colliderBoxes) {
+        rect.x -= viewport.x;
+        rect.y -= viewport.y;
+        SDL_RenderDrawRectF(m_renderer, &rect);
+    }
+
+    stats = RenderStats();
+    for(std::size_t i = 0; i < snapshot.layers.size(); i++) {
+        PROFILE_ZONE(layerZones[i]);
+        drawLayer(m_renderer, m_spriteBatch, m_parallaxCache, snapshot.layers[i], viewport, stats, m_secondPerFrame * interpolation);
+    }
+
+    {
+        PROFILE_ZONE("Present");
+        SDL_RenderPresent(m_renderer);
+    }
+}
+
+// Tick, then draw a snapshot of the registry taken right after
+void Game::runSerial(entt::registry& reg, Setting& setting)
+{
+    SDL_Event event;
+    m_pacer.Reset(setting.GetSecondPerFrame(), setting.GetMaxCatchUpTicks(), setting.GetFrameRateLimit(), setting.IsHeadless());
+    while (!m_quit) {
+        PROFILE_ZONE("Frame");
+        const int ticks = m_pacer.BeginFrame();
+
+        {
+            PROFILE_ZONE("Events");
+            while (SDL_PollEvent(&event)) {
+                if (!handleEngineEvent(event, setting)) {
+                    invokeCallOnEvent(reg, event);
+                }
+            }
+        }
+        applyCommands(reg);
+
+        for(int i = 0; i < ticks; i++) {
+            tick(reg, setting);
+        }
+        takeSnapshot(reg, m_snapshot, m_cameraOffset);
+        drawFrame(m_snapshot, setting, m_pacer.GetInterpolation(), m_renderStats);
+        m_pacer.WaitForFrame();
+    }
+}
+
+// Tick and draw as usual, so a loading screen runs, until the loader decoded
+// every image. The atlas is built here, textures have to be made on the main thread.
+void Game::runLoading(entt::registry& reg, Setting& setting)
+{
+    SDL_Event event;
+    std::size_t reported = m_assetLoader.GetCount() + 1;
+    m_pacer.Reset(setting.GetSecondPerFrame(), setting.GetMaxCatchUpTicks(), setting.GetFrameRateLimit(), setting.IsHeadless());
+    while (!m_quit) {
+        PROFILE_ZONE("Loading");
+        const int ticks = m_pacer.BeginFrame();
+
+        while (SDL_PollEvent(&event)) {
+            if (!handleEngineEvent(event, setting)) {
+                invokeCallOnEvent(reg, event);
+            }
+        }
+        applyCommands(reg);
+
+        const std::size_t loaded = m_assetLoader.GetLoaded();
+        if(loaded != reported) {
+            reported = loaded;
+            if(m_onLoadProgress) m_onLoadProgress(loaded, m_assetLoader.GetCount());
+            applyCommands(reg);
+        }
+        if(m_assetLoader.IsDone()) {
+            PROFILE_ZONE("Build atlas");
+            m_onAssetsLoaded();
+            m_onAssetsLoaded = nullptr;
+            m_onLoadProgress = nullptr;
+            applyCommands(reg);
+            return;
+        }
+
+        for(int i = 0; i < ticks; i++) {
+            tick(reg, setting);
+        }
+        takeSnapshot(reg, m_snapshot, m_cameraOffset);
+        drawFrame(m_snapshot, setting, m_pacer.GetInterpolation(), m_renderStats);
+        m_pacer.WaitForFrame();
+    }
+}
+
+// The simulation ticks on a thread of its own and publishes a snapshot after
+// its ticks. The main thread polls events, passes them on and draws the newest
+// snapshot while the next one is simulated.
+void Game::runPipelined(entt::registry& reg, Setting& setting)
+{
+    const float ms_per_update = setting.GetSecondPerFrame() * 1000.0f;
+    SnapshotExchange exchange;
+    std::mutex eventsMutex;
+    std::vector<SDL_Event> events;
+
+    // The simulation thread can't make textures, from here on GetTexture only reads
+    for(std::size_t i = 0; i < ASSET_COUNT; i++) {
+        GetTexture(static_cast<AssetId>(i));
+    }
+
+    std::thread simulation([&reg, &setting, &exchange, &eventsMutex, &events]() {
+        CommandBuffer::SetMainThread();
+        std::vector<SDL_Event> pending;
+        m_pacer.Reset(setting.GetSecondPerFrame(), setting.GetMaxCatchUpTicks(), 0, setting.IsHeadless());
+        while (!m_quit) {
+            m_pacer.WaitForTick();
+            PROFILE_ZONE("Simulation");
+            const int ticks = m_pacer.BeginFrame();
+
+            {
+                std::lock_guard<std::mutex> lock(eventsMutex);
+                std::swap(pending, events);
+            }
+            for(const auto& event : pending) {
+                invokeCallOnEvent(reg, event);
+            }
+            pending.clear();
+            applyCommands(reg);
+
+            for(int i = 0; i < ticks; i++) {
+                tick(reg, setting);
+            }
+            takeSnapshot(reg, m_snapshot, m_cameraOffset);
+            m_snapshot.lag = m_pacer.GetLagMilliseconds();
+            m_snapshot.time = SDL_GetPerformanceCounter();
+            exchange.Publish(m_snapshot, m_renderStats);
+        }
+    });
+
+    // The render side only uses its pacer for the frame rate limit
+    FramePacer renderPacer;
+    renderPacer.Reset(setting.GetSecondPerFrame(), setting.GetMaxCatchUpTicks(), setting.GetFrameRateLimit(), false);
+    RenderSnapshot snapshot;
+    RenderStats stats;
+    SDL_Event event;
+    const float countsPerMs = static_cast<float>(SDL_GetPerformanceFrequency()) / 1000.0f;
+    while (!m_quit) {
+        PROFILE_ZONE("Frame");
+        renderPacer.BeginFrame();
+        {
+            PROFILE_ZONE("Events");
+            while (SDL_PollEvent(&event)) {
+                if (!handleEngineEvent(event, setting)) {
+                    std::lock_guard<std::mutex> lock(eventsMutex);
+                    events.push_back(event);
+                }
+            }
+        }
+
+        // Time since the snapshot was taken counts as lag, at most one tick
+        // so sprites don't run off when the simulation stalls
+        exchange.Take(snapshot, stats);
+        const float sinceSnapshot = snapshot.time ? static_cast<float>(SDL_GetPerformanceCounter() - snapshot.time) / countsPerMs : 0.0f;
+        drawFrame(snapshot, setting, std::min((snapshot.lag + sinceSnapshot) / ms_per_update, 1.0f), stats);
+        renderPacer.WaitForFrame();
+    }
+
+    simulation.join();
+}
+
+void Game::useTextureAtlas()
+{
+    for(const auto& sprite : m_textureAtlas.GetSprites()) {
+        // A texture loaded on its own before is replaced by the sprite on the page
+        auto findResult = m_textureCache.find(sprite.first);
+        if(findResult != m_textureCache.end()) {
+            SDL_DestroyTexture(findResult->second);
+            m_textureCache.erase(findResult);
+        }
+        m_textureRectCache[sprite.first] = sprite.second;
+    }
+    m_assetTextures = {};
+}
+
+void Game::LoadTextureAtlasAsync(const std::vector<std::string>& paths, std::function<void(std::size_t, std::size_t)> onProgress, std::function<void(void)> onLoaded, int pageSize, int padding)
+{
+    m_assetLoader.Start(paths, std::max(SDL_GetCPUCount() - 1, 1));
+    m_onLoadProgress = std::move(onProgress);
+    m_onAssetsLoaded = [onLoaded = std::move(onLoaded), pageSize, padding]() {
+        const std::vector<std::string> loadedPaths = m_assetLoader.GetPaths();
+        m_textureAtlas.Build(m_renderer, loadedPaths, m_assetLoader.Take(), pageSize, padding);
+        useTextureAtlas();
+        if(onLoaded) onLoaded();
+    };
 }
 
 void Game::Run(Setting& setting, const std::function<void(void)>& onSetup)
 {
+    // Headless runs use the dummy video driver, it has to be picked before SDL_Init
+    if (setting.IsHeadless()) {
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    }
+
     // Initialize SDL
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         std::cerr << "SDL initialization failed: " << SDL_GetError() << std::endl;
@@ -211,94 +753,94 @@ void Game::Run(Setting& setting, const std::function<void(void)>& onSetup)
     m_window = SDL_CreateWindow(setting.GetTitle().c_str(),
         SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
         windowSize.width, windowSize.height,
-        SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
+        setting.IsHeadless() ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
     if (!m_window) {
         std::cerr << "Failed to create SDL window: " << SDL_GetError() << std::endl;
         SDL_Quit();
         return;
     }
 
-    // Create SDL renderer with hardware acceleration
-    m_renderer = SDL_CreateRenderer(m_window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    // Create SDL renderer with hardware acceleration, or a software renderer without vsync when headless
+    m_renderer = SDL_CreateRenderer(m_window, -1,
+        setting.IsHeadless() ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
     if (!m_renderer) {
         std::cerr << "Failed to create SDL renderer: " << SDL_GetError() << std::endl;
         SDL_DestroyWindow(m_window);
         SDL_Quit();
         return;
     }
+    m_renderThread = std::this_thread::get_id();
 
-    // For ScriptComponent and SearchableComponent call the Constructor and Destructor class on construct and destruct.
+    // Script pools call OnConstructed and OnDestroyed themselves, removing the ScriptComponent drops the script.
+    // For SearchableComponent keep the name map up to date.
     entt::registry& reg = Registry::Get();
-    reg.on_construct<ScriptComponent>().connect<&onScriptComponentConstructed>();
     reg.on_destroy<ScriptComponent>().connect<&onScriptComponentDestroyed>();
     reg.on_construct<SearchableComponent>().connect<&onSearchableComponentConstructed>();
     reg.on_destroy<SearchableComponent>().connect<&onSearchableComponentDestroyed>();
+    // The renderer keeps its own copy of every parallax background and its strips
+    reg.on_construct<ParallaxComponent>().connect<&onParallaxComponentConstructed>();
+    reg.on_update<ParallaxComponent>().connect<&onParallaxComponentUpdated>();
+    reg.on_destroy<ParallaxComponent>().connect<&onParallaxComponentChanged>();
     
+    Profiler::SetEnabled(!setting.GetProfileTracePath().empty());
+
+    // Worker threads for the systems, the main thread works along
+    const int workerThreads = setting.GetWorkerThreads() >= 0 ? setting.GetWorkerThreads() : std::max(SDL_GetCPUCount() - 1, 0);
+    JobSystem::Start(workerThreads);
+
+    // Engine systems running after the scripts and collisions of every tick,
+    // systems added in onSetup run after them. Movement owns the position and
+    // velocity pools, nothing else may sort them.
+    m_systems.Clear();
+    reg.group<PositionComponent, VelocityComponent>();
+    AddSystem("Movement", Reads<VelocityComponent>{}, Writes<PositionComponent>{}, invokeMovement);
+    AddSystem("Parallax", Reads<DisabledTag>{}, Writes<ParallaxComponent>{}, invokeParallax);
+    AddSystem("Particles", Reads<DisabledTag>{}, Writes<ParticleEmitterComponent>{}, invokeParticles);
+
+    // Same seed, same game
+    std::uint64_t seed = setting.GetRandomSeed();
+    if(seed == 0) {
+        std::random_device device;
+        seed = (static_cast<std::uint64_t>(device()) << 32) | device();
+    }
+    SeedRandom(seed);
+
     // Let the user set up it things
     m_secondPerFrame = setting.GetSecondPerFrame();
+    m_collisionGrid.SetCellSize(setting.GetCollisionCellSize());
+    CommandBuffer::SetMainThread();
     onSetup();
+    applyCommands(reg);
 
-    // Enter the main loop
-    bool quit = false;
-    SDL_Event event;
-    float ms_per_update = setting.GetSecondPerFrame() * 1000.0f;
-    float previous = static_cast<float>(SDL_GetTicks64());
-    float lag = 0.0f;
-    while (!quit) {
-        float current = static_cast<float>(SDL_GetTicks64());
-        float elapsed = current - previous;
-        previous = current;
-        lag += elapsed;
-
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                quit = true;
-            }
-            else if(event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
-                setting.SetWindowSize(event.window.data1, event.window.data2);
-                setupRenderer(m_renderer, setting);
-            }
-            else {
-                invokeCallOnEvent(reg, event);
-            }
-        }
+    // Enter the main loop, after the loading screen if the setup loads asynchronously.
+    // Keyed on the callback, with no paths the loader never starts but onLoaded is still due.
+    m_quit = false;
+    if(m_onAssetsLoaded) {
+        runLoading(reg, setting);
+    }
+    if(setting.IsPipelined()) {
+        runPipelined(reg, setting);
+    }
+    else {
+        runSerial(reg, setting);
+    }
 
-        SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255); // Black
-        SDL_RenderClear(m_renderer);
-
-        while(lag >= ms_per_update) {
-            lag -= ms_per_update;
-            invokeCallOnUpdate(reg, m_secondPerFrame);
-            invokeOnColition<ColitionLayer1Tag>(reg, m_renderer, m_secondPerFrame);
-            invokeOnColition<ColitionLayer2Tag>(reg, m_renderer, m_secondPerFrame);
-            invokeOnColition<ColitionLayer3Tag>(reg, m_renderer, m_secondPerFrame);
-            invokeOnColition<ColitionLayer4Tag>(reg, m_renderer, m_secondPerFrame);
-            invokeOnColition<ColitionLayer5Tag>(reg, m_renderer, m_secondPerFrame);
-            invokeOnColition<ColitionLayer6Tag>(reg, m_renderer, m_secondPerFrame);
-            invokeOnColition<ColitionLayer7Tag>(reg, m_renderer, m_secondPerFrame);
-            invokeOnColition<ColitionLayer8Tag>(reg, m_renderer, m_secondPerFrame);
-            invokeMovement(reg, m_secondPerFrame);
-        }
-        invokeDrawAddBlendTexture<RenderLayer1Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawTexture<RenderLayer1Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawAddBlendTexture<RenderLayer2Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawTexture<RenderLayer2Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawAddBlendTexture<RenderLayer3Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawTexture<RenderLayer3Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawAddBlendTexture<RenderLayer4Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawTexture<RenderLayer4Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawAddBlendTexture<RenderLayer5Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawTexture<RenderLayer5Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawAddBlendTexture<RenderLayer6Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawTexture<RenderLayer6Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawAddBlendTexture<RenderLayer7Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawTexture<RenderLayer7Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawAddBlendTexture<RenderLayer8Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
-        invokeDrawTexture<RenderLayer8Tag>(reg, m_renderer, m_secondPerFrame, lag / ms_per_update);
+    JobSystem::Stop();
 
-        SDL_RenderPresent(m_renderer);
+    if (!setting.GetProfileTracePath().empty()) {
+        Profiler::WriteChromeTrace(setting.GetProfileTracePath());
     }
 
+    // The renderer owns the textures, forget them before it goes away
+    m_assetLoader.Cancel();
+    m_onAssetsLoaded = nullptr;
+    m_onLoadProgress = nullptr;
+    m_textureAtlas.Clear();
+    m_textureRectCache.clear();
+    m_textureCache.clear();
+    m_assetTextures = {};
+    m_parallaxCache.Clear();
+
     SDL_DestroyRenderer(m_renderer);
     SDL_DestroyWindow(m_window);
     SDL_Quit();
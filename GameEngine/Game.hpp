@@ -1,73 +1,260 @@
 #pragma once
 #include <SDL.h>
 #include <SDL_image.h>
-#include <map>
+#include <array>
+#include <atomic>
+#include <iostream>
+#include <thread>
 #include <unordered_map>
-#include <random>
 #include <entity/registry.hpp>
 #include "GameEngine.hpp"
-
-// Add to the game clear EnTT registry and call onApply function
-template<typename Func>
-static void AddToGame(Func onApply, bool reset = false) {
-    if (reset) Registry::Get().clear();
-    onApply();
-}
+#include "SpatialGrid.hpp"
+#include "SpriteBatch.hpp"
+#include "JobSystem.hpp"
+#include "SystemScheduler.hpp"
+#include "ParallaxCache.hpp"
+#include "RenderSnapshot.hpp"
+#include "FramePacer.hpp"
+#include "Random.hpp"
+#include "TextureAtlas.hpp"
+#include "AssetLoader.hpp"
+#include "Assets.hpp"
 
 class Game {
     static SDL_Window* m_window;
     static SDL_Renderer* m_renderer;
+    static std::thread::id m_renderThread;
     static std::unordered_map<std::string, SDL_Texture*> m_textureCache;
     static float m_secondPerFrame;
-    static std::unordered_map<std::string, entt::entity> m_searchableMap;
+    static std::atomic<bool> m_quit;
+    static SpatialGrid m_collisionGrid;
+    static SpriteBatch m_spriteBatch;
+    static SystemScheduler m_systems;
+    static ParallaxCache m_parallaxCache;
+    static entt::dense_map<entt::id_type, entt::entity, entt::identity> m_searchableMap;
+    static std::uint32_t m_searchableRevision;
+    static bool m_maintenanceRequested;
+    static int m_ticksSinceMaintenance;
+    static SDL_FPoint m_cameraOffset;
+    static RenderStats m_renderStats;
+    static RenderSnapshot m_snapshot;
+    static FramePacer m_pacer;
 
-    static std::random_device m_randomDevice;
-    static std::mt19937 m_radomGenerator;
-    static std::map<std::pair<float, float>, std::uniform_real_distribution<float>> m_randomDistributions;
+    static Random m_random;
+    static std::uint64_t m_randomSeed;
 
     static std::unordered_map<std::string, TextureComponent> m_textureRectCache;
+    static TextureAtlas m_textureAtlas;
+    static std::array<TextureComponent, ASSET_COUNT> m_assetTextures;
+    static AssetLoader m_assetLoader;
+    static std::function<void(std::size_t, std::size_t)> m_onLoadProgress;
+    static std::function<void(void)> m_onAssetsLoaded;
 
-    static void onScriptComponentConstructed(entt::registry& reg, entt::entity self);
     static void onScriptComponentDestroyed(entt::registry& reg, entt::entity self);
+    static void onParallaxComponentConstructed(entt::registry& reg, entt::entity entity);
+    static void onParallaxComponentChanged(entt::registry& reg, entt::entity entity);
+    static void onParallaxComponentUpdated(entt::registry& reg, entt::entity entity);
     static void onSearchableComponentConstructed(entt::registry& reg, entt::entity entity);
     static void onSearchableComponentDestroyed(entt::registry& reg, entt::entity entity);
 
+    static bool handleEngineEvent(const SDL_Event& event, Setting& setting);
+    static void tick(entt::registry& reg, const Setting& setting);
+    static void drawFrame(RenderSnapshot& snapshot, const Setting& setting, float interpolation, RenderStats& stats);
+    static void runSerial(entt::registry& reg, Setting& setting);
+    static void runPipelined(entt::registry& reg, Setting& setting);
+    static void runLoading(entt::registry& reg, Setting& setting);
+    static void useTextureAtlas();
+
 public:
     // Run function to initialize SDL window, renderer, and enter event loop
     static void Run(Setting& setting, const std::function<void(void)>& onSetup);
 
-    // Random Generator
-    static float GenerateRandom(float from, float to) {
-        std::pair<float, float> key = {from, to};
+    // Add a system running every tick after the scripts and collisions. Systems
+    // that don't write what the other reads or writes run at the same time.
+    //
+    //     Game::AddSystem("Spin", Reads<>{}, Writes<AngleComponent>{}, [](entt::registry& reg, float dt) { ... });
+    template<typename... Read, typename... Write>
+    static void AddSystem(const char* name, Reads<Read...> reads, Writes<Write...> writes, SystemScheduler::Function function) {
+        m_systems.Add(name, reads, writes, std::move(function));
+    }
 
-        // Check if the distribution for this range already exists
-        if (m_randomDistributions.find(key) == m_randomDistributions.end()) {
-            // If not, create and store it
-            m_randomDistributions[key] = std::uniform_real_distribution<float>(from, to);
-        }
+    // Mark changes of T so HasChanged and EachChanged can find them, see ChangeTracking
+    template<typename T>
+    static void TrackChanges() {
+        ChangeTracking::Track<T>(Registry::Get());
+    }
+
+    // Call func(entity, T&) for every T changed since the start of the previous tick
+    template<typename T, typename Func>
+    static void EachChanged(Func func) {
+        ChangeTracking::EachChanged<T>(Registry::Get(), std::move(func));
+    }
 
-        // Use the distribution to generate a random float
-        return m_randomDistributions[key](m_radomGenerator);
+    // Top left corner of the view in world coordinates, sprites are drawn
+    // relative to it and culled against it. Parallax backgrounds stay put.
+    static void SetCameraOffset(float x, float y) {
+        m_cameraOffset = SDL_FPoint{ x, y };
     }
 
-    // Find game object that has searchable component
-    static GameObject FindGameObject(const std::string& name) {
-        auto findResult = m_searchableMap.find(name);
+    static SDL_FPoint GetCameraOffset() {
+        return m_cameraOffset;
+    }
+
+    // Stats of the last frame drawn, with a pipelined Setting the frame drawn
+    // before the last snapshot was taken
+    static const RenderStats& GetRenderStats() {
+        return m_renderStats;
+    }
+
+    // Frame time and ticks per frame histograms of the main loop, with a
+    // pipelined Setting of the simulation thread
+    static const FramePacer& GetFramePacer() {
+        return m_pacer;
+    }
+
+    // Sort and trim the component pools at the start of the next tick
+    static void RequestMaintenance() {
+        m_maintenanceRequested = true;
+    }
+
+    // Leave the main loop after the current frame
+    static void Quit() {
+        m_quit = true;
+    }
+
+    // Restart the generators from seed, Run does it with the Setting's seed
+    static void SeedRandom(std::uint64_t seed) {
+        m_randomSeed = seed;
+        m_random.Seed(seed);
+    }
+
+    static std::uint64_t GetRandomSeed() {
+        return m_randomSeed;
+    }
+
+    // Generator of the calling thread. Scripts share the main thread's, every
+    // job system worker has a stream of its own.
+    static Random& GetRandom();
+
+    static constexpr std::uint64_t THREAD_STREAMS = 1ull << 63;
+
+    // A generator of its own for a system, the same seed and stream give the
+    // same numbers no matter which thread the system runs on. Use a stream
+    // above 0 and below THREAD_STREAMS.
+    static Random CreateRandom(std::uint64_t stream) {
+        return Random(m_randomSeed, stream);
+    }
+
+    // Random number in [from, to) from the calling thread's generator
+    static float GenerateRandom(float from, float to) {
+        return GetRandom().Range(from, to);
+    }
+
+    // Find game object that has searchable component, FindGameObject("player"_hs)
+    static GameObject FindGameObject(entt::id_type id) {
+        auto findResult = m_searchableMap.find(id);
         if(findResult == m_searchableMap.end()) return GameObject(Registry::Get(), entt::null);
         return GameObject(Registry::Get(), findResult->second);
     }
 
+    // Changes whenever a searchable component comes or goes
+    static std::uint32_t GetSearchableRevision() {
+        return m_searchableRevision;
+    }
+
+    // Textures are made on the render thread, a pipelined simulation can only
+    // get the ones loaded before it started
     static TextureComponent LoadTexture(const std::string& path) {
-        if (m_textureRectCache.find(path) != m_textureRectCache.end()) {
-            return TextureComponent{ m_textureRectCache[path] };
+        auto findResult = m_textureRectCache.find(path);
+        if (findResult != m_textureRectCache.end()) {
+            return findResult->second;
+        } else if (std::this_thread::get_id() != m_renderThread) {
+            std::cerr << "Can't load " << path << " off the render thread, load it in the setup" << std::endl;
+            return TextureComponent{ nullptr, 0.0f, 0.0f, SDL_Rect{ 0, 0, 0, 0 } };
         } else {
             auto textureComponent = TextureComponent{ IMG_LoadTexture(m_renderer, path.c_str()) };
             int w, h;
             SDL_QueryTexture(textureComponent.texture, 0, 0, &w, &h);
             textureComponent.width = static_cast<float>(w);
             textureComponent.height = static_cast<float>(h);
+            textureComponent.source = SDL_Rect{ 0, 0, w, h };
             m_textureRectCache[path] = textureComponent;
+            if (textureComponent.texture) m_textureCache[path] = textureComponent.texture;
             return textureComponent;
         }
     }
+
+    // Pack the images into atlas pages, LoadTexture then returns the sprite on its page.
+    // Textures of the same images loaded one by one before are destroyed, sprites
+    // still using them have to be replaced, like a scene reset does.
+    static void LoadTextureAtlas(const std::vector<std::string>& paths, int pageSize = 1024, int padding = 2) {
+        if (std::this_thread::get_id() != m_renderThread) {
+            std::cerr << "Can't build a texture atlas off the render thread, build it in the setup" << std::endl;
+            return;
+        }
+        m_textureAtlas.Build(m_renderer, paths, pageSize, padding);
+        useTextureAtlas();
+    }
+
+    // Same, but the images are decoded on loader threads while the game runs,
+    // so the setup calling it can show a loading screen. onProgress(loaded, total) is called
+    // on the main thread when more images are decoded, onLoaded once the atlas
+    // is built. Until then textures are loaded one by one as usual.
+    static void LoadTextureAtlasAsync(const std::vector<std::string>& paths, std::function<void(std::size_t, std::size_t)> onProgress, std::function<void(void)> onLoaded, int pageSize = 1024, int padding = 2);
+
+    // Progress of LoadTextureAtlasAsync, also for checking single images by index
+    static const AssetLoader& GetAssetLoader() {
+        return m_assetLoader;
+    }
+
+    // Texture of an image in gfx/ by its generated id, loaded on first use.
+    // Afterwards it is an array index, no path is looked up. A pipelined run
+    // loads them all before the simulation starts, that thread only reads.
+    static const TextureComponent& GetTexture(AssetId id) {
+        auto& texture = m_assetTextures[static_cast<std::size_t>(id)];
+        if (!texture.texture && std::this_thread::get_id() == m_renderThread) {
+            texture = LoadTexture(AssetPath(id));
+        }
+        return texture;
+    }
+};
+
+// Add to the game clear EnTT registry and call onApply function. A reset and
+// anything added off the main thread happens at the next sync point, so the
+// registry is never cleared while scripts iterate it.
+template<typename Func>
+static void AddToGame(Func onApply, bool reset = false) {
+    if (reset || !CommandBuffer::IsMainThread()) {
+        CommandBuffer::Get().Record([onApply, reset](entt::registry& reg) mutable {
+            if (reset) reg.clear();
+            onApply();
+            if (reset) Game::RequestMaintenance();
+        });
+        return;
+    }
+    onApply();
+}
+
+// Remembers what FindGameObject found and only looks again after a searchable
+// component came or went, so hot script paths check one integer.
+//
+//     GameObjectHandle player{ "player"_hs };
+//     if(player.Get().IsValid()) { ... }
+class GameObjectHandle {
+    entt::id_type m_id;
+    entt::entity m_entity = entt::null;
+    std::uint32_t m_revision = 0;
+    bool m_found = false;
+
+public:
+    explicit GameObjectHandle(entt::id_type id): m_id(id) {}
+
+    GameObject Get() {
+        if(!m_found || m_revision != Game::GetSearchableRevision()) {
+            m_entity = Game::FindGameObject(m_id).GetEntity();
+            m_revision = Game::GetSearchableRevision();
+            m_found = true;
+        }
+        return GameObject(Registry::Get(), m_entity);
+    }
 };
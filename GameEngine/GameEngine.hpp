@@ -1,8 +1,10 @@
 #pragma once
 #include "Setting.hpp"
 #include "Registry.hpp"
+#include "Profiler.hpp"
+#include "CommandBuffer.hpp"
 #include "GameObject.hpp"
-#include "ColitionLayers.hpp"
+#include "ChangeTracking.hpp"
 #include "RenderLayers.hpp"
 #include "ScriptComponent.hpp"
 #include "PositionComponent.hpp"
@@ -10,4 +12,7 @@
 #include "TextureComponent.hpp"
 #include "SearchableComponent.hpp"
 #include "AABBComponent.hpp"
-#include "AddBlenderComponent.hpp"
\ No newline at end of file
+#include "AddBlenderComponent.hpp"
+#include "CollisionMaskComponent.hpp"
+#include "ParallaxComponent.hpp"
+#include "ParticleEmitterComponent.hpp"
\ No newline at end of file
@@ -1,11 +1,21 @@
 #pragma once
 #include <entt.hpp>
+#include <cassert>
+#include <tuple>
+#include <type_traits>
 #include "Registry.hpp"
+#include "PooledComponent.hpp"
+#include "CommandBuffer.hpp"
+#include "VelocityComponent.hpp"
+#include "ChangeTracking.hpp"
+
+class ScriptComponent;
 
 class GameObject {
 public:
-    // Constructor to create a new entity
-    GameObject(): m_entity(Registry::Get().create()) {}
+    // Constructor to create a new entity, off the main thread a placeholder
+    // until the next sync point, see CommandBuffer
+    GameObject(): m_entity(CommandBuffer::IsMainThread() ? create() : CommandBuffer::Get().Create()) {}
 
     // Constructor to use an existing entity
     GameObject(entt::registry& reg, entt::entity entity): m_entity(entity) {}
@@ -13,7 +23,23 @@ public:
     // Template method to add or replace a component
     template<typename T, typename... Args>
     GameObject& AddComponent(Args&&... args) {
-        Registry::Get().emplace_or_replace<T>(m_entity, std::forward<Args>(args)...);
+        // Off the main thread the component is added at the next sync point
+        if(!CommandBuffer::IsMainThread()) {
+            CommandBuffer::Get().Record([entity = m_entity, values = std::make_tuple(std::decay_t<Args>(std::forward<Args>(args))...)](entt::registry& reg) mutable {
+                std::apply([&reg, entity](auto&... arguments) {
+                    GameObject(reg, CommandBuffer::Resolve(entity)).AddComponent<T>(std::move(arguments)...);
+                }, values);
+            });
+            return *this;
+        }
+
+        // Scripts go to the pool of their own type
+        if constexpr(std::is_same_v<T, ScriptComponent>) {
+            T::Attach(m_entity, std::forward<Args>(args)...);
+        }
+        else {
+            Registry::Get().emplace_or_replace<T>(m_entity, std::forward<Args>(args)...);
+        }
         return *this;
     }
 
@@ -23,6 +49,27 @@ public:
         return Registry::Get().get<T>(m_entity);
     }
 
+    // Change a component in place and let tracked changes know about it.
+    // Off the main thread the change is made at the next sync point.
+    template<typename T, typename Func>
+    GameObject& PatchComponent(Func func) {
+        if(!CommandBuffer::IsMainThread()) {
+            CommandBuffer::Get().Record([entity = m_entity, func = std::move(func)](entt::registry& reg) mutable {
+                GameObject(reg, CommandBuffer::Resolve(entity)).PatchComponent<T>(std::move(func));
+            });
+            return *this;
+        }
+        Registry::Get().patch<T>(m_entity, std::move(func));
+        return *this;
+    }
+
+    // True when T was added, replaced or patched since the start of the previous
+    // tick. Only works for types passed to Game::TrackChanges.
+    template<typename T>
+    bool HasChanged() const {
+        return ChangeTracking::HasChanged<T>(Registry::Get(), m_entity);
+    }
+
     // Template method to check if a component exists
     template<typename T>
     bool HasComponent() const {
@@ -32,22 +79,73 @@ public:
     // Template method to remove a component
     template<typename T>
     GameObject& RemoveComponent() {
+        if(!CommandBuffer::IsMainThread()) {
+            CommandBuffer::Get().Record([entity = m_entity](entt::registry& reg) {
+                GameObject(reg, CommandBuffer::Resolve(entity)).RemoveComponent<T>();
+            });
+            return *this;
+        }
         if(Registry::Get().any_of<T>(m_entity)) {
             Registry::Get().erase<T>(m_entity);
         }
         return *this;
     }
 
+    // Take an entity of the Prefab pool or create a new one that joins the pool.
+    // Destroy parks pooled entities with all their components instead of
+    // destroying them, so the prefab has to add every component again. Scripts
+    // of reused entities get no OnConstructed and parked ones no OnDestroyed.
+    template<typename Prefab>
+    static GameObject FromPool() {
+        assert(CommandBuffer::IsMainThread() && "Pools are only used by prefabs, AddToGame runs them on the main thread");
+        auto& reg = Registry::Get();
+        auto& parked = reg.storage<Parked<Prefab>>();
+        if(!parked.empty()) {
+            const entt::entity entity = parked.data()[parked.size() - 1];
+            reg.remove<Parked<Prefab>, DisabledTag>(entity);
+            return GameObject(reg, entity);
+        }
+
+        GameObject gameObject(reg, create());
+        reg.emplace<PooledComponent>(gameObject.m_entity, &release<Prefab>);
+        return gameObject;
+    }
+
+    // The entity is destroyed, or parked if pooled, at the next sync point.
+    // On the main thread it is disabled right away.
     void Destroy() {
-        if(Registry::Get().valid(m_entity)) {
-            Registry::Get().destroy(m_entity);
+        if(!IsValid()) return;
+        if(CommandBuffer::IsMainThread()) {
+            Registry::Get().emplace<DisabledTag>(m_entity);
         }
+        CommandBuffer::Get().Destroy(m_entity);
     }
 
+    // False for destroyed, disabled and parked entities
     bool IsValid() {
-        return Registry::Get().valid(m_entity);
+        auto& reg = Registry::Get();
+        return reg.valid(m_entity) && !reg.all_of<DisabledTag>(m_entity);
+    }
+
+    entt::entity GetEntity() const {
+        return m_entity;
     }
 
 private:
     entt::entity m_entity;
+
+    // The registry's entity pool is not thread safe, other threads record creates
+    static entt::entity create() {
+        assert(CommandBuffer::IsMainThread() && "Entities can only be created on the main thread");
+        return Registry::Get().create();
+    }
+
+    template<typename Prefab>
+    static void release(entt::registry& reg, entt::entity entity) {
+        // Movement still integrates disabled entities, parked ones must not drift off
+        if(auto* velocity = reg.try_get<VelocityComponent>(entity)) {
+            *velocity = VelocityComponent{ 0.0f, 0.0f };
+        }
+        reg.emplace<Parked<Prefab>>(entity);
+    }
 };
@@ -0,0 +1,132 @@
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "JobSystem.hpp"
+
+namespace {
+    struct Task {
+        const JobSystem::Job* job;
+        std::atomic<std::size_t>* pending;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Queue 0 belongs to the thread that started the workers
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<bool> running(false);
+    std::atomic<int> queued(0);
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+
+    thread_local std::size_t queueIndex = 0;
+
+    // Own queue from the back, the others from the front
+    bool takeTask(Task& task) {
+        const std::size_t count = queues.size();
+        for(std::size_t i = 0; i < count; i++) {
+            const std::size_t index = (queueIndex + i) % count;
+            auto& queue = *queues[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if(queue.tasks.empty()) continue;
+            if(i == 0) {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+            }
+            else {
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+            }
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    bool runOne() {
+        Task task;
+        if(!takeTask(task)) return false;
+        (*task.job)();
+        task.pending->fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void workerLoop(std::size_t index) {
+        queueIndex = index;
+        while(running.load(std::memory_order_acquire)) {
+            if(runOne()) continue;
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait(lock, [] { return !running.load() || queued.load() > 0; });
+        }
+    }
+}
+
+void JobSystem::Start(int workers)
+{
+    Stop();
+    queues.push_back(std::make_unique<Queue>());
+    running = true;
+    for(int i = 0; i < workers; i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for(int i = 0; i < workers; i++) {
+        threads.emplace_back(workerLoop, static_cast<std::size_t>(i + 1));
+    }
+}
+
+void JobSystem::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        running = false;
+    }
+    wake.notify_all();
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    queues.clear();
+}
+
+int JobSystem::GetWorkerCount()
+{
+    return static_cast<int>(threads.size());
+}
+
+std::size_t JobSystem::GetThreadIndex()
+{
+    return queueIndex;
+}
+
+void JobSystem::Run(const std::vector<Job>& jobs)
+{
+    if(threads.empty()) {
+        for(const auto& job : jobs) job();
+        return;
+    }
+
+    std::atomic<std::size_t> pending(jobs.size());
+    {
+        auto& queue = *queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for(const auto& job : jobs) {
+            queue.tasks.push_back(Task{ &job, &pending });
+        }
+        queued.fetch_add(static_cast<int>(jobs.size()), std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wake.notify_all();
+
+    // Help out until our jobs are done, they may have been stolen
+    while(pending.load(std::memory_order_acquire) > 0) {
+        if(!runOne()) std::this_thread::yield();
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// Work stealing thread pool. Every thread has its own job queue, idle workers
+// steal from the others. A thread waiting for its jobs runs jobs meanwhile,
+// so jobs may start and wait for more jobs.
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    // Start the worker threads, with 0 workers every job runs on the calling thread
+    static void Start(int workers);
+
+    // Finish the queued jobs and join the workers
+    static void Stop();
+
+    static int GetWorkerCount();
+
+    // 1 to the worker count on the workers, 0 on any other thread
+    static std::size_t GetThreadIndex();
+
+    // Run all jobs, possibly in parallel, and return when they are done
+    static void Run(const std::vector<Job>& jobs);
+
+    // Call func(begin, end) for chunks of at most grain items covering [0, count)
+    template<typename Func>
+    static void ParallelFor(std::size_t count, std::size_t grain, Func func) {
+        if(count == 0) return;
+        grain = std::max<std::size_t>(grain, 1);
+        if(GetWorkerCount() == 0 || count <= grain) {
+            func(std::size_t(0), count);
+            return;
+        }
+
+        std::vector<Job> jobs;
+        jobs.reserve((count + grain - 1) / grain);
+        for(std::size_t begin = 0; begin < count; begin += grain) {
+            const std::size_t end = std::min(begin + grain, count);
+            jobs.push_back([&func, begin, end] { func(begin, end); });
+        }
+        Run(jobs);
+    }
+};
@@ -0,0 +1,104 @@
+#include <iostream>
+#include "ParallaxCache.hpp"
+#include "Random.hpp"
+
+ParallaxCache::~ParallaxCache()
+{
+    Clear();
+}
+
+SDL_Texture* ParallaxCache::bake(SDL_Renderer* renderer, const ParallaxComponent& parallax, std::size_t band)
+{
+    SDL_Texture* strip = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, parallax.width, parallax.height);
+    if(!strip) {
+        std::cerr << "Failed to create parallax strip: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+    SDL_SetTextureBlendMode(strip, SDL_BLENDMODE_ADD);
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, strip);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    // Every band gets its own stream, so a band looks the same when baked again
+    Random random(parallax.seed, band);
+
+    for(int i = 0; i < parallax.bands[band].count && !parallax.sprites.empty(); i++) {
+        const auto& sprite = parallax.sprites[random.Below(static_cast<std::uint32_t>(parallax.sprites.size()))];
+        if(!sprite.texture) continue;
+        SDL_SetTextureBlendMode(sprite.texture, SDL_BLENDMODE_BLEND);
+
+        SDL_Rect dst = {
+            static_cast<int>(random.NextFloat() * parallax.width),
+            static_cast<int>(random.NextFloat() * (parallax.height - sprite.height)),
+            static_cast<int>(sprite.width),
+            static_cast<int>(sprite.height)
+        };
+        SDL_RenderCopy(renderer, sprite.texture, &sprite.source, &dst);
+
+        // Sprites crossing the right edge continue on the left, the strip wraps around
+        if(dst.x + dst.w > parallax.width) {
+            dst.x -= parallax.width;
+            SDL_RenderCopy(renderer, sprite.texture, &sprite.source, &dst);
+        }
+    }
+
+    SDL_SetRenderTarget(renderer, previousTarget);
+    return strip;
+}
+
+void ParallaxCache::destroyStrips(Entry& entry)
+{
+    for(auto* strip : entry.strips) {
+        if(strip) SDL_DestroyTexture(strip);
+    }
+    entry.strips.clear();
+}
+
+void ParallaxCache::Define(entt::entity entity, ParallaxComponent parallax)
+{
+    auto& entry = m_entries[entity];
+    destroyStrips(entry);
+    entry.parallax = std::move(parallax);
+}
+
+const ParallaxCache::Entry* ParallaxCache::Get(SDL_Renderer* renderer, entt::entity entity)
+{
+    auto findResult = m_entries.find(entity);
+    if(findResult == m_entries.end()) return nullptr;
+
+    auto& entry = findResult->second;
+    if(entry.strips.empty() && !entry.parallax.bands.empty()) {
+        // Without render targets every band gets no strip, and is not tried again
+        const bool supported = SDL_RenderTargetSupported(renderer);
+        if(!supported) {
+            std::cerr << "Parallax background needs render target support" << std::endl;
+        }
+        for(std::size_t band = 0; band < entry.parallax.bands.size(); band++) {
+            entry.strips.push_back(supported ? bake(renderer, entry.parallax, band) : nullptr);
+        }
+    }
+    return &entry;
+}
+
+void ParallaxCache::Release(entt::entity entity)
+{
+    auto findResult = m_entries.find(entity);
+    if(findResult == m_entries.end()) return;
+    destroyStrips(findResult->second);
+    m_entries.erase(findResult);
+}
+
+void ParallaxCache::DropStrips()
+{
+    for(auto& entry : m_entries) {
+        destroyStrips(entry.second);
+    }
+}
+
+void ParallaxCache::Clear()
+{
+    DropStrips();
+    m_entries.clear();
+}
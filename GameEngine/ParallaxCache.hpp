@@ -0,0 +1,47 @@
+#pragma once
+#include <SDL.h>
+#include <unordered_map>
+#include <vector>
+#include <entity/registry.hpp>
+#include "ParallaxComponent.hpp"
+
+// Render target strips of the ParallaxComponents, baked on first use. The
+// cache keeps a copy of every background it was told about, so the renderer
+// bakes and draws them without looking at the registry.
+class ParallaxCache {
+public:
+    struct Entry {
+        ParallaxComponent parallax;
+        std::vector<SDL_Texture*> strips;   // One per band once baked
+    };
+
+private:
+    std::unordered_map<entt::entity, Entry> m_entries;
+
+    static SDL_Texture* bake(SDL_Renderer* renderer, const ParallaxComponent& parallax, std::size_t band);
+    static void destroyStrips(Entry& entry);
+
+public:
+    ParallaxCache() = default;
+    ParallaxCache(const ParallaxCache&) = delete;
+    ParallaxCache& operator=(const ParallaxCache&) = delete;
+    ~ParallaxCache();
+
+    // Remember the background of an entity, strips baked for it before are dropped
+    void Define(entt::entity entity, ParallaxComponent parallax);
+
+    // The background with its strips, baked if there are none yet. Null for
+    // entities never defined, the strips are null if the renderer does not
+    // support render targets.
+    const Entry* Get(SDL_Renderer* renderer, entt::entity entity);
+
+    // Forget the background of one entity and destroy its strips
+    void Release(entt::entity entity);
+
+    // Destroy all strips, they are baked again when drawn next time. Needed
+    // when the renderer lost the content of its render targets.
+    void DropStrips();
+
+    // Destroy all strips and forget all backgrounds
+    void Clear();
+};
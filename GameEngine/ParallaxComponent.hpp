@@ -0,0 +1,21 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "TextureComponent.hpp"
+
+// Scrolling background made of sprites scattered over a few bands. Every band
+// is baked once into a render target strip of width x height pixels and then
+// drawn wrapped around, so the background costs two blits per band and frame.
+struct ParallaxComponent {
+    struct Band {
+        float speed;        // Horizontal velocity in pixels per second
+        int count;          // Number of sprites scattered over the strip
+        SDL_Color color;    // Color and opacity the strip is added with
+        float offset = 0.0f;
+    };
+
+    std::vector<TextureComponent> sprites;
+    std::vector<Band> bands;
+    int width, height;
+    unsigned int seed;      // The same seed bakes the same strips
+};
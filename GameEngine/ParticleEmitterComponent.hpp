@@ -0,0 +1,104 @@
+#pragma once
+#include <SDL.h>
+#include <cstddef>
+#include <vector>
+#include "TextureComponent.hpp"
+
+// Particles of one emitter kept as structure of arrays, so the update is a
+// plain loop over floats the compiler can vectorize. Particles are in world
+// coordinates and do not follow the emitter entity.
+class ParticleBuffer {
+public:
+    std::vector<float> x, y;
+    std::vector<float> dx, dy;
+    std::vector<float> alpha;       // 0 to 255
+    std::vector<float> life;        // Seconds left
+    std::vector<SDL_Color> color;   // The alpha of color is not used
+
+    std::size_t GetSize() const {
+        return x.size();
+    }
+
+    void Emit(float px, float py, float vx, float vy, SDL_Color c, float a, float seconds) {
+        x.push_back(px);
+        y.push_back(py);
+        dx.push_back(vx);
+        dy.push_back(vy);
+        alpha.push_back(a);
+        life.push_back(seconds);
+        color.push_back(c);
+    }
+
+    // Add count particles living for seconds and return the index of the first,
+    // the caller fills in the rest, for bursts with Random::Fill
+    std::size_t Grow(std::size_t count, float seconds) {
+        const std::size_t first = GetSize();
+        x.resize(first + count);
+        y.resize(first + count);
+        dx.resize(first + count);
+        dy.resize(first + count);
+        alpha.resize(first + count);
+        life.resize(first + count, seconds);
+        color.resize(first + count);
+        return first;
+    }
+
+    // Move and fade every particle, then drop the dead ones
+    void Update(float dt, float fadeRate) {
+        Integrate(0, GetSize(), dt, fadeRate);
+        RemoveDead();
+    }
+
+    // Move and fade the particles in [begin, end), ranges may be done in parallel
+    void Integrate(std::size_t begin, std::size_t end, float dt, float fadeRate) {
+        float* px = x.data();
+        float* py = y.data();
+        float* pa = alpha.data();
+        float* pl = life.data();
+        const float* vx = dx.data();
+        const float* vy = dy.data();
+        const float fade = fadeRate * dt;
+
+        for(std::size_t i = begin; i < end; i++) {
+            px[i] += vx[i] * dt;
+            py[i] += vy[i] * dt;
+            pa[i] = pa[i] > fade ? pa[i] - fade : 0.0f;
+            pl[i] -= dt;
+        }
+    }
+
+    // Swap dead particles with the last one, the order does not matter
+    void RemoveDead() {
+        for(std::size_t i = 0; i < x.size();) {
+            if(life[i] > 0.0f) {
+                i++;
+                continue;
+            }
+            removeAt(i);
+        }
+    }
+
+    void Clear() {
+        x.clear(); y.clear(); dx.clear(); dy.clear();
+        alpha.clear(); life.clear(); color.clear();
+    }
+
+private:
+    void removeAt(std::size_t i) {
+        x[i] = x.back(); x.pop_back();
+        y[i] = y.back(); y.pop_back();
+        dx[i] = dx.back(); dx.pop_back();
+        dy[i] = dy.back(); dy.pop_back();
+        alpha[i] = alpha.back(); alpha.pop_back();
+        life[i] = life.back(); life.pop_back();
+        color[i] = color.back(); color.pop_back();
+    }
+};
+
+// Draws all particles of the buffer with the same texture in one batch
+struct ParticleEmitterComponent {
+    TextureComponent texture;
+    SDL_BlendMode blendMode;
+    float fadeRate;             // Alpha lost per second
+    ParticleBuffer particles;
+};
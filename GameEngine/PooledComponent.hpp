@@ -0,0 +1,19 @@
+#pragma once
+#include <entt.hpp>
+
+// Skipped by the engine: not drawn, collided or updated. Still moved by the
+// movement system, which iterates a group that can't exclude it, parked pool
+// entities have their velocity zeroed instead.
+struct DisabledTag {};
+
+// Destroyed since the last tick, returns to its pool when the next tick starts
+struct ParkingTag {};
+
+// Entities of a prefab pool ready to be reused
+template<typename Prefab>
+struct Parked {};
+
+// Marks an entity of a prefab pool, see GameObject::FromPool
+struct PooledComponent {
+    void (*release)(entt::registry& reg, entt::entity entity);  // Adds Parked<Prefab>
+};
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Profiler.hpp"
+
+namespace {
+    struct Event {
+        const char* name;
+        Uint64 start;
+        Uint64 end;
+    };
+
+    struct RingBuffer {
+        std::vector<Event> events;
+        std::size_t next = 0;
+        bool wrapped = false;
+        int threadId = 0;
+    };
+
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<RingBuffer>> buffers;
+    std::size_t capacity = 1 << 16;
+
+    // The buffers outlive their threads so a trace can still be written after they exit
+    RingBuffer& threadBuffer() {
+        thread_local RingBuffer* buffer = nullptr;
+        if(buffer == nullptr) {
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            buffers.push_back(std::make_unique<RingBuffer>());
+            buffer = buffers.back().get();
+            buffer->events.resize(capacity);
+            buffer->threadId = static_cast<int>(buffers.size());
+        }
+        return *buffer;
+    }
+
+    void writeEscaped(std::ofstream& out, const char* text) {
+        for(; *text; text++) {
+            if(*text == '"' || *text == '\\') out << '\\';
+            out << *text;
+        }
+    }
+}
+
+std::atomic<bool> Profiler::m_enabled(false);
+
+void Profiler::SetCapacity(std::size_t events)
+{
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    capacity = events > 0 ? events : 1;
+}
+
+void Profiler::Record(const char* name, Uint64 start, Uint64 end)
+{
+    auto& buffer = threadBuffer();
+    buffer.events[buffer.next] = Event{ name, start, end };
+    if(++buffer.next == buffer.events.size()) {
+        buffer.next = 0;
+        buffer.wrapped = true;
+    }
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path)
+{
+    std::ofstream out(path);
+    if(!out) return false;
+
+    const double microsecondsPerTick = 1000000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+
+    std::lock_guard<std::mutex> lock(buffersMutex);
+
+    // Make the timestamps relative to the oldest recorded zone
+    Uint64 origin = ~Uint64(0);
+    for(const auto& buffer : buffers) {
+        const std::size_t count = buffer->wrapped ? buffer->events.size() : buffer->next;
+        for(std::size_t i = 0; i < count; i++) {
+            origin = std::min(origin, buffer->events[i].start);
+        }
+    }
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for(const auto& buffer : buffers) {
+        const std::size_t count = buffer->wrapped ? buffer->events.size() : buffer->next;
+        const std::size_t begin = buffer->wrapped ? buffer->next : 0;
+        for(std::size_t i = 0; i < count; i++) {
+            const auto& event = buffer->events[(begin + i) % buffer->events.size()];
+            out << (first ? "\n" : ",\n") << "{\"name\":\"";
+            writeEscaped(out, event.name);
+            out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"ts\":" << static_cast<double>(event.start - origin) * microsecondsPerTick
+                << ",\"dur\":" << static_cast<double>(event.end - event.start) * microsecondsPerTick << "}";
+            first = false;
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return static_cast<bool>(out);
+}
+
+void Profiler::Clear()
+{
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for(auto& buffer : buffers) {
+        buffer->next = 0;
+        buffer->wrapped = false;
+    }
+}
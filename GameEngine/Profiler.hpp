@@ -0,0 +1,63 @@
+#pragma once
+#include <SDL.h>
+#include <atomic>
+#include <string>
+
+// Scoped timers for the engine and scripts. Zones are recorded into a ring
+// buffer per thread and can be written as a Chrome trace_event JSON file,
+// open it in chrome://tracing or https://ui.perfetto.dev.
+//
+//     void OnUpdate(GameObject& self, float dt) {
+//         PROFILE_ZONE("EnemyScript::OnUpdate");
+//         ...
+//     }
+//
+// When profiling is disabled a zone costs one relaxed atomic load.
+class Profiler {
+    static std::atomic<bool> m_enabled;
+
+public:
+    class Zone {
+        const char* m_name;
+        Uint64 m_start;
+
+    public:
+        explicit Zone(const char* name)
+            : m_name(Profiler::IsEnabled() ? name : nullptr)
+            , m_start(m_name ? SDL_GetPerformanceCounter() : 0)
+        {}
+
+        ~Zone() {
+            if(m_name) Profiler::Record(m_name, m_start, SDL_GetPerformanceCounter());
+        }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+    };
+
+    static bool IsEnabled() {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    static void SetEnabled(bool enabled) {
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    // Number of zones each thread keeps before the oldest are overwritten,
+    // takes effect for threads that have not recorded anything yet
+    static void SetCapacity(std::size_t events);
+
+    // Name is expected to be a string literal, only the pointer is stored
+    static void Record(const char* name, Uint64 start, Uint64 end);
+
+    // Write the recorded zones of all threads. Call it between frames, when the
+    // engine threads are not inside a zone. Returns false if the file can't be written.
+    static bool WriteChromeTrace(const std::string& path);
+
+    // Forget everything recorded so far
+    static void Clear();
+};
+
+#define PROFILE_ZONE_CONCAT_INNER(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_ZONE_CONCAT(profileZone, __LINE__)(name)
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// xoshiro128** generator. Small, fast and seedable, good for gameplay but not
+// for anything secret. Generators made with the same seed and a different
+// stream are independent, give every thread or system its own.
+class Random {
+    std::uint32_t m_state[4];
+
+    static std::uint32_t rotl(std::uint32_t x, int k) {
+        return (x << k) | (x >> (32 - k));
+    }
+
+    static std::uint64_t splitMix(std::uint64_t& x) {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+public:
+    explicit Random(std::uint64_t seed = 0, std::uint64_t stream = 0) {
+        Seed(seed, stream);
+    }
+
+    // The state is filled by splitmix64, so similar seeds and streams still
+    // give unrelated sequences
+    void Seed(std::uint64_t seed, std::uint64_t stream = 0) {
+        std::uint64_t x = seed;
+        x ^= splitMix(stream);
+        const std::uint64_t a = splitMix(x);
+        const std::uint64_t b = splitMix(x);
+        m_state[0] = static_cast<std::uint32_t>(a);
+        m_state[1] = static_cast<std::uint32_t>(a >> 32);
+        m_state[2] = static_cast<std::uint32_t>(b);
+        m_state[3] = static_cast<std::uint32_t>(b >> 32);
+    }
+
+    std::uint32_t Next() {
+        const std::uint32_t result = rotl(m_state[1] * 5, 7) * 9;
+        const std::uint32_t t = m_state[1] << 9;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 11);
+        return result;
+    }
+
+    // Uniform in [0, 1), from the top 24 bits
+    float NextFloat() {
+        return static_cast<float>(Next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // Uniform in [from, to)
+    float Range(float from, float to) {
+        return from + (to - from) * NextFloat();
+    }
+
+    // Uniform in [0, bound), multiply and shift instead of a modulo
+    std::uint32_t Below(std::uint32_t bound) {
+        return static_cast<std::uint32_t>((static_cast<std::uint64_t>(Next()) * bound) >> 32);
+    }
+
+    // Fill out with count numbers uniform in [from, to)
+    void Fill(float* out, std::size_t count, float from, float to) {
+        const float scale = (to - from) * (1.0f / 16777216.0f);
+        for(std::size_t i = 0; i < count; i++) {
+            out[i] = from + static_cast<float>(Next() >> 8) * scale;
+        }
+    }
+};
@@ -0,0 +1,97 @@
+#pragma once
+#include <SDL.h>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <entity/registry.hpp>
+#include "ParallaxComponent.hpp"
+
+// Sprites and particles of a frame sent to the renderer or culled for being
+// outside the viewport
+struct RenderStats {
+    std::size_t drawn = 0;
+    std::size_t culled = 0;
+};
+
+// Everything the renderer needs of one simulated frame, copied out of the
+// registry so drawing never touches it.
+struct RenderSnapshot {
+    struct Sprite {
+        SDL_Texture* texture;
+        SDL_Rect source;
+        SDL_BlendMode blendMode;
+        SDL_Color color;
+        float x, y, dx, dy;     // Drawn moved along the velocity by the interpolation
+        float width, height;
+    };
+
+    // What moves of a parallax band, the strips themselves are in the cache
+    struct ParallaxBand {
+        float offset, speed;
+        SDL_Color color;
+    };
+
+    struct Parallax {
+        entt::entity entity;
+        std::size_t firstBand, bandCount;   // In the parallaxBands of the layer
+    };
+
+    struct Layer {
+        std::vector<Parallax> parallax;
+        std::vector<ParallaxBand> parallaxBands;
+        std::vector<Sprite> sprites;    // In draw order
+    };
+
+    std::array<Layer, 8> layers;
+    std::vector<SDL_FRect> colliderBoxes;
+    std::vector<entt::entity> releasedParallax;  // Baked strips to drop before drawing
+    std::vector<std::pair<entt::entity, ParallaxComponent>> definedParallax;    // New backgrounds for the cache, after the releases
+    SDL_FPoint cameraOffset = { 0.0f, 0.0f };
+    float lag = 0.0f;       // Milliseconds not ticked yet when it was taken
+    Uint64 time = 0;        // Performance counter when it was taken
+};
+
+// Hands snapshots from the simulation thread to the render thread. Both sides
+// swap their snapshot with the shared one, so no sprite is copied twice and the
+// vectors keep their memory. The render stats go the other way.
+class SnapshotExchange {
+    std::mutex m_mutex;
+    RenderSnapshot m_shared;
+    bool m_fresh = false;
+    RenderStats m_stats;
+
+public:
+    // Give a filled snapshot to the renderer and get the stats of its last frame
+    void Publish(RenderSnapshot& snapshot, RenderStats& stats) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Nobody drew the previous one, its strips still have to be released and
+        // its backgrounds defined, unless this one releases them again
+        if(m_fresh) {
+            auto& defined = m_shared.definedParallax;
+            for(auto entity : snapshot.releasedParallax) {
+                defined.erase(std::remove_if(defined.begin(), defined.end(), [entity](const auto& entry) { return entry.first == entity; }), defined.end());
+            }
+            defined.insert(defined.end(), std::make_move_iterator(snapshot.definedParallax.begin()), std::make_move_iterator(snapshot.definedParallax.end()));
+            snapshot.definedParallax.swap(defined);
+            snapshot.releasedParallax.insert(snapshot.releasedParallax.begin(), m_shared.releasedParallax.begin(), m_shared.releasedParallax.end());
+        }
+        std::swap(snapshot, m_shared);
+        snapshot.releasedParallax.clear();
+        snapshot.definedParallax.clear();
+        m_fresh = true;
+        stats = m_stats;
+    }
+
+    // Swap in the newest snapshot, false if there is none since the last call
+    bool Take(RenderSnapshot& snapshot, const RenderStats& stats) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats = stats;
+        if(!m_fresh) return false;
+        std::swap(snapshot, m_shared);
+        m_fresh = false;
+        return true;
+    }
+};
@@ -2,9 +2,18 @@
 #include <SDL.h>
 #include <cstdint>
 #include <memory>
+#include <type_traits>
+#include <vector>
 #include <entity/registry.hpp>
+#include "Registry.hpp"
 #include "GameObject.hpp"
 
+// Scripts up to this size in bytes are stored inline in their pool, larger
+// ones on the heap so they do not blow up the pool pages
+#ifndef SCRIPT_INLINE_SIZE
+#define SCRIPT_INLINE_SIZE 64
+#endif
+
 struct Script {
     void OnConstructed(GameObject& self) {}
     void OnEvent(GameObject& self, const SDL_Event& event) {}
@@ -13,87 +22,189 @@ struct Script {
     void OnDestroyed(GameObject& self) {}
 };
 
+// Scripts are added with AddComponent<ScriptComponent>(MyScript{}). The script
+// itself is stored in a pool of its own type, so the engine updates all
+// scripts of one type in a tight loop with direct, inlinable calls. The
+// ScriptComponent only remembers which type the entity's script has.
+//
+// Hooks a script does not declare itself are found at compile time, the
+// engine never calls them. A script type without OnUpdate gets no update loop,
+// one without OnCollision is left out of collision dispatch.
 class ScriptComponent {
 public:
-    struct IScript {
-        virtual ~IScript() = default;
-        virtual void OnConstructed(GameObject& self) = 0;
-        virtual void OnEvent(GameObject& self, const SDL_Event& event) = 0;
-        virtual void OnUpdate(GameObject& self, float dt) = 0;
-        virtual void OnCollision(GameObject& self, GameObject& other) = 0;
-        virtual void OnDestroyed(GameObject& self) = 0;
-        virtual std::unique_ptr<IScript> clone() const = 0;
+    using UpdateSystem = void (*)(entt::registry& reg, float dt);
+    using EventSystem = void (*)(entt::registry& reg, const SDL_Event& event);
+
+    // The script object, one pool per script type
+    template<typename T, bool Inline = (sizeof(T) <= SCRIPT_INLINE_SIZE)>
+    struct Instance {
+        T script;
+
+        Instance(T value) : script(std::move(value)) {}
+
+        T& Get() {
+            return script;
+        }
+    };
+
+    template<typename T>
+    struct Instance<T, false> {
+        std::unique_ptr<T> script;
+
+        Instance(T value) : script(std::make_unique<T>(std::move(value))) {}
+
+        T& Get() {
+            return *script;
+        }
     };
 
 private:
-    std::unique_ptr<IScript> script;
+    // What the engine needs to reach the script of a single entity,
+    // onCollision is null if the script does not handle collisions
+    struct Hooks {
+        void (*onCollision)(GameObject& self, GameObject& other);
+        void (*remove)(entt::registry& reg, entt::entity entity);
+    };
 
+    // A hook inherited from Script is a member of Script, one declared by the
+    // script is a member of T
     template<typename T>
-    class ScriptModel : public IScript {        
-        T scriptImpl;
+    struct Implements {
+        static constexpr bool OnConstructed = !std::is_same_v<decltype(&T::OnConstructed), decltype(&Script::OnConstructed)>;
+        static constexpr bool OnEvent = !std::is_same_v<decltype(&T::OnEvent), decltype(&Script::OnEvent)>;
+        static constexpr bool OnUpdate = !std::is_same_v<decltype(&T::OnUpdate), decltype(&Script::OnUpdate)>;
+        static constexpr bool OnCollision = !std::is_same_v<decltype(&T::OnCollision), decltype(&Script::OnCollision)>;
+        static constexpr bool OnDestroyed = !std::is_same_v<decltype(&T::OnDestroyed), decltype(&Script::OnDestroyed)>;
+    };
 
-    public:
-        ScriptModel(T script) : scriptImpl(std::move(script)) {}
+    const Hooks* m_hooks;
 
-        void OnConstructed(GameObject& self) override {
-            scriptImpl.OnConstructed(self);
-        }
+    static std::vector<UpdateSystem>& updateSystems() {
+        static std::vector<UpdateSystem> systems;
+        return systems;
+    }
 
-        void OnEvent(GameObject& self, const SDL_Event& event) override {
-            scriptImpl.OnEvent(self, event);
-        }
+    static std::vector<EventSystem>& eventSystems() {
+        static std::vector<EventSystem> systems;
+        return systems;
+    }
 
-        void OnUpdate(GameObject& self, float dt) override {
-            scriptImpl.OnUpdate(self, dt);
+    // Visit the pool back to front like EnTT does, skipping parked entities.
+    // On the main thread scripts add and remove components and scripts right
+    // away while we iterate, so the size is checked every step.
+    template<typename T, typename Func>
+    static void each(entt::registry& reg, Func func) {
+        auto& pool = reg.storage<Instance<T>>();
+        for(std::size_t pos = pool.size(); pos-- > 0;) {
+            if(pos >= pool.size()) continue;
+            const entt::entity entity = pool.data()[pos];
+            if(reg.all_of<DisabledTag>(entity)) continue;
+            GameObject self(reg, entity);
+            func(self, pool.get(entity).Get());
         }
+    }
 
-        void OnCollision(GameObject& self, GameObject& other) override {
-            scriptImpl.OnCollision(self, other);
-        }
+    template<typename T>
+    static void updateAll(entt::registry& reg, float dt) {
+        each<T>(reg, [dt](GameObject& self, T& script) {
+            script.OnUpdate(self, dt);
+        });
+    }
 
-        void OnDestroyed(GameObject& self) override {
-            scriptImpl.OnDestroyed(self);
-        }
+    template<typename T>
+    static void eventAll(entt::registry& reg, const SDL_Event& event) {
+        each<T>(reg, [&event](GameObject& self, T& script) {
+            script.OnEvent(self, event);
+        });
+    }
 
-        std::unique_ptr<IScript> clone() const override {
-            return std::make_unique<ScriptModel>(*this);
-        }
-    };
+    template<typename T>
+    static void onConstructed(entt::registry& reg, entt::entity entity) {
+        GameObject self(reg, entity);
+        reg.get<Instance<T>>(entity).Get().OnConstructed(self);
+    }
+
+    template<typename T>
+    static void onDestroyed(entt::registry& reg, entt::entity entity) {
+        GameObject self(reg, entity);
+        reg.get<Instance<T>>(entity).Get().OnDestroyed(self);
+    }
+
+    template<typename T>
+    static void onCollision(GameObject& self, GameObject& other) {
+        Registry::Get().get<Instance<T>>(self.GetEntity()).Get().OnCollision(self, other);
+    }
+
+    template<typename T>
+    static void remove(entt::registry& reg, entt::entity entity) {
+        reg.remove<Instance<T>>(entity);
+    }
+
+    // Set up the pool of a script type the first time it is used, subscribing
+    // only to the hooks the script implements
+    template<typename T>
+    static const Hooks* hooks() {
+        static const Hooks hooks = [] {
+            auto& reg = Registry::Get();
+            if constexpr(Implements<T>::OnConstructed) {
+                reg.on_construct<Instance<T>>().template connect<&onConstructed<T>>();
+            }
+            if constexpr(Implements<T>::OnDestroyed) {
+                reg.on_destroy<Instance<T>>().template connect<&onDestroyed<T>>();
+            }
+            if constexpr(Implements<T>::OnUpdate) {
+                updateSystems().push_back(&updateAll<T>);
+            }
+            if constexpr(Implements<T>::OnEvent) {
+                eventSystems().push_back(&eventAll<T>);
+            }
+            if constexpr(Implements<T>::OnCollision) {
+                return Hooks{ &onCollision<T>, &remove<T> };
+            }
+            else {
+                return Hooks{ nullptr, &remove<T> };
+            }
+        }();
+        return &hooks;
+    }
+
+    explicit ScriptComponent(const Hooks* hooks) : m_hooks(hooks) {}
 
 public:
+    // Called by GameObject::AddComponent<ScriptComponent>(script)
     template<typename T>
-    ScriptComponent(T script) : script(std::make_unique<ScriptModel<T>>(std::move(script))) {}
+    static void Attach(entt::entity entity, T script) {
+        auto& reg = Registry::Get();
+        const Hooks* scriptHooks = hooks<T>();
 
-    ScriptComponent(const ScriptComponent& other) : script(other.script ? other.script->clone() : nullptr) {}
- 
-    ScriptComponent& operator=(const ScriptComponent& other) {
-        if (this != &other) {
-            script = other.script ? other.script->clone() : nullptr;
+        // Replacing a script of another type drops the old one
+        if(auto* current = reg.try_get<ScriptComponent>(entity); current && current->m_hooks != scriptHooks) {
+            current->m_hooks->remove(reg, entity);
         }
-        return *this;
-    }
 
-    void OnConstructed(GameObject& self) {
-        if (script) script->OnConstructed(self);
+        reg.emplace_or_replace<ScriptComponent>(entity, ScriptComponent(scriptHooks));
+        reg.emplace_or_replace<Instance<T>>(entity, std::move(script));
     }
 
-    void OnEvent(GameObject& self, const SDL_Event& event) {
-        if (script) script->OnEvent(self, event);
+    // Drop the script object, the engine calls this when the ScriptComponent is removed
+    static void Detach(entt::registry& reg, entt::entity entity) {
+        reg.get<ScriptComponent>(entity).m_hooks->remove(reg, entity);
     }
 
-    void OnUpdate(GameObject& self, float dt) {
-        if (script) script->OnUpdate(self, dt);
+    // One update and event loop per script type that has been used and implements the hook
+    static const std::vector<UpdateSystem>& GetUpdateSystems() {
+        return updateSystems();
     }
 
-    void OnCollision(GameObject& self, GameObject& other) {
-        if (script) script->OnCollision(self, other);
+    static const std::vector<EventSystem>& GetEventSystems() {
+        return eventSystems();
     }
 
-    void OnDestroyed(GameObject& self) {
-        if (script) script->OnDestroyed(self);
+    bool HandlesCollision() const {
+        return m_hooks->onCollision != nullptr;
     }
 
-    ~ScriptComponent() {
-        script.release();
+    void OnCollision(GameObject& self, GameObject& other) const {
+        if(m_hooks->onCollision) m_hooks->onCollision(self, other);
     }
 };
@@ -1,6 +1,8 @@
 #pragma once
-#include <string>
+#include <core/hashed_string.hpp>
 
+// Makes the entity findable with Game::FindGameObject. The name is hashed at
+// compile time, AddComponent<SearchableComponent>("player"_hs).
 struct SearchableComponent {
-    std::string name;
+    entt::id_type id;
 };
@@ -1,4 +1,6 @@
 #pragma once
+#include <array>
+#include <cstdint>
 #include <string>
 
 class Setting {
@@ -12,6 +14,17 @@ private:
     Size m_logicalSize;
     Size m_windowSize;
     float m_secondPerFrame;
+    float m_collisionCellSize;
+    std::array<std::uint32_t, 32> m_collisionMatrix;
+    std::uint32_t m_continuousCollisionLayers;
+    bool m_headless;
+    std::string m_profileTracePath;
+    int m_workerThreads;
+    int m_maintenanceInterval;
+    bool m_pipelined;
+    int m_maxCatchUpTicks;
+    int m_frameRateLimit;
+    std::uint64_t m_randomSeed;
 
 public:
     Setting()
@@ -19,6 +32,16 @@ public:
         , m_logicalSize({512, 512})
         , m_windowSize({512, 512})
         , m_secondPerFrame(0.01)
+        , m_collisionCellSize(128.0f)
+        , m_collisionMatrix({})
+        , m_continuousCollisionLayers(0)
+        , m_headless(false)
+        , m_workerThreads(-1)
+        , m_maintenanceInterval(500)
+        , m_pipelined(false)
+        , m_maxCatchUpTicks(5)
+        , m_frameRateLimit(0)
+        , m_randomSeed(0)
     {}
 
     const std::string& GetTitle() const {
@@ -56,4 +79,129 @@ public:
         m_secondPerFrame = secondPerFrame;
         return *this;
     }
+
+    float GetCollisionCellSize() const {
+        return m_collisionCellSize;
+    }
+
+    // Size in pixels of a collision broadphase cell, about the size of the larger colliders
+    Setting& SetCollisionCellSize(float cellSize) {
+        m_collisionCellSize = cellSize;
+        return *this;
+    }
+
+    // Let colliders in any of layers get OnCollision for colliders in otherLayers
+    Setting& SetCollidesWith(std::uint32_t layers, std::uint32_t otherLayers) {
+        for(int bit = 0; bit < 32; bit++) {
+            if(layers & (1u << bit)) m_collisionMatrix[bit] |= otherLayers;
+        }
+        return *this;
+    }
+
+    // Layers that a collider in any of layers collides with
+    std::uint32_t GetCollidesWith(std::uint32_t layers) const {
+        std::uint32_t otherLayers = 0;
+        for(int bit = 0; layers != 0; bit++, layers >>= 1) {
+            if(layers & 1u) otherLayers |= m_collisionMatrix[bit];
+        }
+        return otherLayers;
+    }
+
+    std::uint32_t GetContinuousCollision() const {
+        return m_continuousCollisionLayers;
+    }
+
+    // Use swept AABB for the layers, so fast colliders can't pass through others between ticks
+    Setting& SetContinuousCollision(std::uint32_t layers) {
+        m_continuousCollisionLayers = layers;
+        return *this;
+    }
+
+    bool IsHeadless() const {
+        return m_headless;
+    }
+
+    // Run without a visible window on SDL's dummy video driver and a software
+    // renderer, one fixed tick per frame as fast as possible. Used for benchmarks.
+    Setting& SetHeadless(bool headless) {
+        m_headless = headless;
+        return *this;
+    }
+
+    const std::string& GetProfileTracePath() const {
+        return m_profileTracePath;
+    }
+
+    // Enable the profiler and write a Chrome trace to path when the game exits
+    Setting& SetProfileTracePath(const std::string& path) {
+        m_profileTracePath = path;
+        return *this;
+    }
+
+    int GetWorkerThreads() const {
+        return m_workerThreads;
+    }
+
+    // Threads running systems next to the main thread, -1 uses one less than
+    // the number of cores and 0 runs everything on the main thread
+    Setting& SetWorkerThreads(int workerThreads) {
+        m_workerThreads = workerThreads;
+        return *this;
+    }
+
+    int GetMaintenanceInterval() const {
+        return m_maintenanceInterval;
+    }
+
+    // Ticks between sorting the hot component pools into draw order and
+    // trimming them after spikes, 0 only does it on scene reset
+    Setting& SetMaintenanceInterval(int ticks) {
+        m_maintenanceInterval = ticks;
+        return *this;
+    }
+
+    bool IsPipelined() const {
+        return m_pipelined;
+    }
+
+    // Tick on a thread of its own while the main thread draws the last snapshot
+    // of the scene. Scripts then can't load textures, load them all in onSetup.
+    // The generated assets are loaded before the simulation starts.
+    Setting& SetPipelined(bool pipelined) {
+        m_pipelined = pipelined;
+        return *this;
+    }
+
+    int GetMaxCatchUpTicks() const {
+        return m_maxCatchUpTicks;
+    }
+
+    // Most ticks one frame runs to catch up after a stall, the time beyond
+    // that is dropped and the game runs slower for a moment instead
+    Setting& SetMaxCatchUpTicks(int ticks) {
+        m_maxCatchUpTicks = ticks;
+        return *this;
+    }
+
+    int GetFrameRateLimit() const {
+        return m_frameRateLimit;
+    }
+
+    // Sleep so no more than this many frames are drawn per second, for when
+    // vsync is off. 0 doesn't limit.
+    Setting& SetFrameRateLimit(int framesPerSecond) {
+        m_frameRateLimit = framesPerSecond;
+        return *this;
+    }
+
+    std::uint64_t GetRandomSeed() const {
+        return m_randomSeed;
+    }
+
+    // Seed of Game::GenerateRandom and the other generators, the same seed
+    // replays the same game. 0 picks a different seed every run.
+    Setting& SetRandomSeed(std::uint64_t seed) {
+        m_randomSeed = seed;
+        return *this;
+    }
 };
@@ -0,0 +1,184 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <entity/registry.hpp>
+
+// Uniform grid used as collision broadphase. Every tick the grid is cleared and
+// refilled, but the cell buckets keep their memory so steady state does not allocate.
+class SpatialGrid {
+public:
+    struct Box {
+        float x1, y1, x2, y2;
+
+        bool Overlaps(const Box& other) const {
+            return (x1 <= other.x2 && x2 >= other.x1) && (y1 <= other.y2 && y2 >= other.y1);
+        }
+
+        Box Moved(float dx, float dy) const {
+            return Box{ x1 + dx, y1 + dy, x2 + dx, y2 + dy };
+        }
+
+        Box Union(const Box& other) const {
+            return Box{ std::min(x1, other.x1), std::min(y1, other.y1), std::max(x2, other.x2), std::max(y2, other.y2) };
+        }
+
+        // True if the box touches other anywhere while moving (dx, dy) relative to it
+        bool Sweeps(const Box& other, float dx, float dy) const {
+            float enter = 0.0f, exit = 1.0f;
+            if(!sweepAxis(x1, x2, other.x1, other.x2, dx, enter, exit)) return false;
+            if(!sweepAxis(y1, y2, other.y1, other.y2, dy, enter, exit)) return false;
+            return enter <= exit;
+        }
+
+    private:
+        static bool sweepAxis(float a1, float a2, float b1, float b2, float d, float& enter, float& exit) {
+            if(d == 0.0f) return a1 <= b2 && a2 >= b1;
+            float t1 = (b1 - a2) / d;
+            float t2 = (b2 - a1) / d;
+            if(t1 > t2) std::swap(t1, t2);
+            enter = std::max(enter, t1);
+            exit = std::min(exit, t2);
+            return enter <= exit;
+        }
+    };
+
+    struct Item {
+        entt::entity entity;
+        Box box;            // Bounds covering the whole movement during the tick
+        Box start;          // Box at the start of the tick
+        float dx, dy;       // Movement during the tick
+        std::uint32_t category;
+        std::uint32_t collidesWith;
+        bool continuous;
+
+        Box End() const {
+            return start.Moved(dx, dy);
+        }
+
+        bool Collides(const Item& other) const {
+            if(continuous || other.continuous) {
+                return start.Sweeps(other.start, dx - other.dx, dy - other.dy);
+            }
+            return End().Overlaps(other.End());
+        }
+    };
+
+    // Boxes covering more cells are kept in a list of their own and tested
+    // against everything instead of walking their cells
+    static constexpr std::int64_t MAX_BOX_CELLS = 256;
+    static constexpr int MAX_CELL = 1 << 24;
+
+private:
+    float m_cellSize;
+    float m_inverseCellSize;
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> m_cells;
+    std::vector<std::vector<std::uint32_t>*> m_usedCells;
+    std::vector<Item> m_items;
+    std::vector<std::uint32_t> m_oversized;
+
+    // Far out and NaN coordinates end up in the outermost cells, converting them
+    // to int as they are is undefined
+    int cellCoord(float value) const {
+        const float cell = std::floor(value * m_inverseCellSize);
+        if(!(cell > -MAX_CELL)) return -MAX_CELL;
+        if(cell > MAX_CELL) return MAX_CELL;
+        return static_cast<int>(cell);
+    }
+
+    static bool isOversized(int cx1, int cy1, int cx2, int cy2) {
+        return static_cast<std::int64_t>(cx2 - cx1 + 1) * static_cast<std::int64_t>(cy2 - cy1 + 1) > MAX_BOX_CELLS;
+    }
+
+    static std::uint64_t cellKey(int x, int y) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+    }
+
+public:
+    explicit SpatialGrid(float cellSize = 128.0f) {
+        SetCellSize(cellSize);
+    }
+
+    void SetCellSize(float cellSize) {
+        m_cellSize = cellSize;
+        m_inverseCellSize = 1.0f / cellSize;
+        m_cells.clear();
+        m_usedCells.clear();
+        m_items.clear();
+        m_oversized.clear();
+    }
+
+    float GetCellSize() const {
+        return m_cellSize;
+    }
+
+    // Empty all buckets touched since the last clear but keep their capacity.
+    void Clear() {
+        for(auto* cell : m_usedCells) {
+            cell->clear();
+        }
+        m_usedCells.clear();
+        m_items.clear();
+        m_oversized.clear();
+    }
+
+    void Insert(const Item& item) {
+        const auto index = static_cast<std::uint32_t>(m_items.size());
+        const auto& box = item.box;
+        m_items.push_back(item);
+
+        const int cx1 = cellCoord(box.x1), cy1 = cellCoord(box.y1);
+        const int cx2 = cellCoord(box.x2), cy2 = cellCoord(box.y2);
+        if(isOversized(cx1, cy1, cx2, cy2)) {
+            m_oversized.push_back(index);
+            return;
+        }
+        for(int cy = cy1; cy <= cy2; cy++) {
+            for(int cx = cx1; cx <= cx2; cx++) {
+                auto& cell = m_cells[cellKey(cx, cy)];
+                if(cell.empty()) m_usedCells.push_back(&cell);
+                cell.push_back(index);
+            }
+        }
+    }
+
+    std::size_t GetSize() const {
+        return m_items.size();
+    }
+
+    const Item& GetItem(std::uint32_t index) const {
+        return m_items[index];
+    }
+
+    // Call func(index, item) once for every item sharing at least one cell with
+    // box, and for every oversized item. An item is reported in the first cell it
+    // shares with box only, nothing is written, so several threads may query at
+    // once. An oversized box gets every item.
+    template<typename Func>
+    void QueryConcurrent(const Box& box, Func func) const {
+        const int cx1 = cellCoord(box.x1), cy1 = cellCoord(box.y1);
+        const int cx2 = cellCoord(box.x2), cy2 = cellCoord(box.y2);
+        if(isOversized(cx1, cy1, cx2, cy2)) {
+            for(std::size_t index = 0; index < m_items.size(); index++) {
+                func(static_cast<std::uint32_t>(index), m_items[index]);
+            }
+            return;
+        }
+        for(std::uint32_t index : m_oversized) {
+            func(index, m_items[index]);
+        }
+        for(int cy = cy1; cy <= cy2; cy++) {
+            for(int cx = cx1; cx <= cx2; cx++) {
+                auto findResult = m_cells.find(cellKey(cx, cy));
+                if(findResult == m_cells.end()) continue;
+                for(std::uint32_t index : findResult->second) {
+                    const auto& item = m_items[index];
+                    if(cx != std::max(cx1, cellCoord(item.box.x1)) || cy != std::max(cy1, cellCoord(item.box.y1))) continue;
+                    func(index, item);
+                }
+            }
+        }
+    }
+};
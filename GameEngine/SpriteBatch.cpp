@@ -0,0 +1,56 @@
+#include "SpriteBatch.hpp"
+
+SpriteBatch::Batch& SpriteBatch::findBatch(SDL_Texture* texture, SDL_BlendMode blendMode)
+{
+    for(std::size_t i = 0; i < m_used; i++) {
+        if(m_batches[i].texture == texture && m_batches[i].blendMode == blendMode) {
+            return m_batches[i];
+        }
+    }
+
+    if(m_used == m_batches.size()) {
+        m_batches.emplace_back();
+    }
+    auto& batch = m_batches[m_used++];
+    batch.texture = texture;
+    batch.blendMode = blendMode;
+
+    int width = 1, height = 1;
+    SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
+    batch.inverseWidth = 1.0f / static_cast<float>(width);
+    batch.inverseHeight = 1.0f / static_cast<float>(height);
+    return batch;
+}
+
+void SpriteBatch::Draw(SDL_Texture* texture, const SDL_Rect& source, SDL_BlendMode blendMode, const SDL_FRect& dst, SDL_Color color)
+{
+    if(texture == nullptr) return;
+
+    auto& batch = findBatch(texture, blendMode);
+    const int first = static_cast<int>(batch.vertices.size());
+    const float x1 = dst.x, y1 = dst.y;
+    const float x2 = dst.x + dst.w, y2 = dst.y + dst.h;
+    const float u1 = source.x * batch.inverseWidth, v1 = source.y * batch.inverseHeight;
+    const float u2 = (source.x + source.w) * batch.inverseWidth, v2 = (source.y + source.h) * batch.inverseHeight;
+
+    batch.vertices.push_back({ { x1, y1 }, color, { u1, v1 } });
+    batch.vertices.push_back({ { x2, y1 }, color, { u2, v1 } });
+    batch.vertices.push_back({ { x2, y2 }, color, { u2, v2 } });
+    batch.vertices.push_back({ { x1, y2 }, color, { u1, v2 } });
+
+    batch.indices.insert(batch.indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+}
+
+void SpriteBatch::Flush(SDL_Renderer* renderer)
+{
+    for(std::size_t i = 0; i < m_used; i++) {
+        auto& batch = m_batches[i];
+        SDL_SetTextureBlendMode(batch.texture, batch.blendMode);
+        SDL_RenderGeometry(renderer, batch.texture,
+            batch.vertices.data(), static_cast<int>(batch.vertices.size()),
+            batch.indices.data(), static_cast<int>(batch.indices.size()));
+        batch.vertices.clear();
+        batch.indices.clear();
+    }
+    m_used = 0;
+}
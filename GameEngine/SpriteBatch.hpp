@@ -0,0 +1,28 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// Collects textured quads and submits them with one SDL_RenderGeometry call
+// per texture and blend mode, instead of one SDL_RenderCopy per sprite.
+class SpriteBatch {
+    struct Batch {
+        SDL_Texture* texture;
+        SDL_BlendMode blendMode;
+        float inverseWidth, inverseHeight;
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+    };
+
+    // Batches are kept between flushes so their vertex memory is reused
+    std::vector<Batch> m_batches;
+    std::size_t m_used = 0;
+
+    Batch& findBatch(SDL_Texture* texture, SDL_BlendMode blendMode);
+
+public:
+    // Queue the source part of the texture, color is multiplied with the texture and alpha is the opacity
+    void Draw(SDL_Texture* texture, const SDL_Rect& source, SDL_BlendMode blendMode, const SDL_FRect& dst, SDL_Color color = { 255, 255, 255, 255 });
+
+    // Submit the queued sprites in the order their texture and blend mode were first used
+    void Flush(SDL_Renderer* renderer);
+};
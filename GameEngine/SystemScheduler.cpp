@@ -0,0 +1,66 @@
+#include <algorithm>
+#include "SystemScheduler.hpp"
+#include "JobSystem.hpp"
+#include "Profiler.hpp"
+
+bool SystemScheduler::conflicts(const System& a, const System& b)
+{
+    auto contains = [](const std::vector<std::type_index>& set, const std::type_index& type) {
+        return std::find(set.begin(), set.end(), type) != set.end();
+    };
+    for(const auto& type : a.writes) {
+        if(contains(b.reads, type) || contains(b.writes, type)) return true;
+    }
+    for(const auto& type : b.writes) {
+        if(contains(a.reads, type)) return true;
+    }
+    return false;
+}
+
+// Every system goes to the stage after the last earlier system it conflicts
+// with, so conflicting systems keep the order they were added in
+void SystemScheduler::buildStages()
+{
+    m_stages.clear();
+    std::vector<std::size_t> stageOf(m_systems.size(), 0);
+    for(std::size_t i = 0; i < m_systems.size(); i++) {
+        std::size_t stage = 0;
+        for(std::size_t j = 0; j < i; j++) {
+            if(conflicts(m_systems[i], m_systems[j])) stage = std::max(stage, stageOf[j] + 1);
+        }
+        stageOf[i] = stage;
+        if(m_stages.size() <= stage) m_stages.resize(stage + 1);
+        m_stages[stage].push_back(i);
+    }
+    m_dirty = false;
+}
+
+void SystemScheduler::Run(entt::registry& reg, float dt)
+{
+    if(m_dirty) {
+        buildStages();
+        for(const auto& system : m_systems) {
+            system.prepare(reg);
+        }
+    }
+
+    std::vector<JobSystem::Job> jobs;
+    for(const auto& stage : m_stages) {
+        if(stage.size() == 1) {
+            const auto& system = m_systems[stage.front()];
+            PROFILE_ZONE(system.name);
+            system.function(reg, dt);
+            continue;
+        }
+
+        jobs.clear();
+        for(std::size_t index : stage) {
+            const auto& system = m_systems[index];
+            jobs.push_back([&system, &reg, dt] {
+                PROFILE_ZONE(system.name);
+                system.function(reg, dt);
+            });
+        }
+        JobSystem::Run(jobs);
+    }
+}
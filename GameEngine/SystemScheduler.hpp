@@ -0,0 +1,68 @@
+#pragma once
+#include <functional>
+#include <typeindex>
+#include <vector>
+#include <entt.hpp>
+
+// Component sets a system declares when it is added to the scheduler
+template<typename... Components>
+struct Reads {};
+
+template<typename... Components>
+struct Writes {};
+
+// Runs systems in the order they were added, except that systems whose
+// component sets do not conflict run at the same time on the JobSystem. Two
+// systems conflict if one writes a component the other reads or writes.
+//
+// Systems running on worker threads must not create or destroy entities or
+// add and remove components directly, GameObject and AddToGame record those
+// into the CommandBuffer there.
+class SystemScheduler {
+public:
+    using Function = std::function<void(entt::registry& reg, float dt)>;
+
+private:
+    struct System {
+        const char* name;
+        std::vector<std::type_index> reads;
+        std::vector<std::type_index> writes;
+        Function function;
+        void (*prepare)(entt::registry& reg);
+    };
+
+    // EnTT creates storages on first use, which is not thread safe
+    template<typename... Components>
+    static void createStorages(entt::registry& reg) {
+        (reg.storage<Components>(), ...);
+    }
+
+    std::vector<System> m_systems;
+    std::vector<std::vector<std::size_t>> m_stages;
+    bool m_dirty = false;
+
+    static bool conflicts(const System& a, const System& b);
+    void buildStages();
+
+public:
+    // Name is expected to be a string literal, it is used as profiler zone
+    template<typename... Read, typename... Write>
+    void Add(const char* name, Reads<Read...>, Writes<Write...>, Function function) {
+        m_systems.push_back(System{
+            name,
+            { std::type_index(typeid(Read))... },
+            { std::type_index(typeid(Write))... },
+            std::move(function),
+            &createStorages<Read..., Write...>
+        });
+        m_dirty = true;
+    }
+
+    void Clear() {
+        m_systems.clear();
+        m_stages.clear();
+        m_dirty = false;
+    }
+
+    void Run(entt::registry& reg, float dt);
+};
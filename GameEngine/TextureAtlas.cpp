@@ -0,0 +1,132 @@
+#include <SDL_image.h>
+#include <algorithm>
+#include <iostream>
+#include "TextureAtlas.hpp"
+
+namespace {
+    struct Image {
+        const std::string* path;
+        SDL_Surface* surface;
+        int page;
+        SDL_Rect rect;
+    };
+
+    // Shelf packer, fills rows left to right and opens a new row below when full
+    struct Page {
+        int width, height;
+        int x = 0, y = 0, shelfHeight = 0;
+
+        bool Place(int w, int h, int padding, SDL_Rect& rect) {
+            if(x + w + padding > width) {
+                x = 0;
+                y += shelfHeight;
+                shelfHeight = 0;
+            }
+            if(x + w + padding > width || y + h + padding > height) return false;
+
+            rect = SDL_Rect{ x + padding, y + padding, w, h };
+            x += w + padding;
+            shelfHeight = std::max(shelfHeight, h + padding);
+            return true;
+        }
+    };
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    Clear();
+}
+
+void TextureAtlas::Clear()
+{
+    for(auto* page : m_pages) {
+        SDL_DestroyTexture(page);
+    }
+    m_pages.clear();
+    m_sprites.clear();
+}
+
+void TextureAtlas::Build(SDL_Renderer* renderer, const std::vector<std::string>& paths, int pageSize, int padding)
+{
+    std::vector<SDL_Surface*> surfaces;
+    surfaces.reserve(paths.size());
+    for(const auto& path : paths) {
+        SDL_Surface* surface = IMG_Load(path.c_str());
+        if(surface == nullptr) {
+            std::cerr << "Failed to load " << path << ": " << IMG_GetError() << std::endl;
+        }
+        surfaces.push_back(surface);
+    }
+    Build(renderer, paths, surfaces, pageSize, padding);
+}
+
+void TextureAtlas::Build(SDL_Renderer* renderer, const std::vector<std::string>& paths, const std::vector<SDL_Surface*>& surfaces, int pageSize, int padding)
+{
+    Clear();
+
+    std::vector<Image> images;
+    images.reserve(paths.size());
+    for(std::size_t i = 0; i < paths.size(); i++) {
+        if(surfaces[i] == nullptr) continue;
+        images.push_back({ &paths[i], surfaces[i], -1, {} });
+    }
+
+    // Tallest first keeps the shelves tight
+    std::vector<Image*> order;
+    for(auto& image : images) order.push_back(&image);
+    std::stable_sort(order.begin(), order.end(), [](const Image* a, const Image* b) {
+        return a->surface->h > b->surface->h;
+    });
+
+    std::vector<Page> pages;
+    for(auto* image : order) {
+        const int w = image->surface->w, h = image->surface->h;
+        for(std::size_t i = 0; i < pages.size() && image->page < 0; i++) {
+            if(pages[i].Place(w, h, padding, image->rect)) image->page = static_cast<int>(i);
+        }
+        if(image->page < 0) {
+            // Images larger than a page get a page of their own
+            pages.push_back(Page{ std::max(pageSize, w + padding * 2), std::max(pageSize, h + padding * 2) });
+            pages.back().Place(w, h, padding, image->rect);
+            image->page = static_cast<int>(pages.size() - 1);
+        }
+    }
+
+    // Images of a page that could not be made are left out, LoadTexture then
+    // loads them one by one
+    std::vector<SDL_Texture*> pageTextures(pages.size(), nullptr);
+    for(std::size_t i = 0; i < pages.size(); i++) {
+        SDL_Surface* pageSurface = SDL_CreateRGBSurfaceWithFormat(0, pages[i].width, pages[i].height, 32, SDL_PIXELFORMAT_RGBA32);
+        if(pageSurface == nullptr) {
+            std::cerr << "Failed to create atlas page: " << SDL_GetError() << std::endl;
+            continue;
+        }
+        for(auto& image : images) {
+            if(image.page != static_cast<int>(i)) continue;
+            // Copy the pixels as they are, including alpha
+            SDL_SetSurfaceBlendMode(image.surface, SDL_BLENDMODE_NONE);
+            SDL_Rect dst = image.rect;
+            SDL_BlitSurface(image.surface, nullptr, pageSurface, &dst);
+        }
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, pageSurface);
+        SDL_FreeSurface(pageSurface);
+        if(texture == nullptr) {
+            std::cerr << "Failed to upload atlas page: " << SDL_GetError() << std::endl;
+            continue;
+        }
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        pageTextures[i] = texture;
+        m_pages.push_back(texture);
+    }
+
+    for(auto& image : images) {
+        if(pageTextures[image.page]) {
+            m_sprites[*image.path] = TextureComponent{
+                pageTextures[image.page],
+                static_cast<float>(image.rect.w), static_cast<float>(image.rect.h),
+                image.rect
+            };
+        }
+        SDL_FreeSurface(image.surface);
+    }
+}
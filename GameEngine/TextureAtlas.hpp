@@ -0,0 +1,38 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TextureComponent.hpp"
+
+// Packs images into a few large textures, so sprites from different files can
+// share a texture and be drawn in the same batch.
+class TextureAtlas {
+    std::vector<SDL_Texture*> m_pages;
+    std::unordered_map<std::string, TextureComponent> m_sprites;
+
+public:
+    TextureAtlas() = default;
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+    ~TextureAtlas();
+
+    // Load the images and pack them on pages of pageSize x pageSize pixels with
+    // padding pixels between the sprites. Images that fail to load are skipped.
+    void Build(SDL_Renderer* renderer, const std::vector<std::string>& paths, int pageSize, int padding);
+
+    // Same with images decoded already, surfaces[i] is the image of paths[i] or
+    // nullptr to skip it. The surfaces are freed.
+    void Build(SDL_Renderer* renderer, const std::vector<std::string>& paths, const std::vector<SDL_Surface*>& surfaces, int pageSize, int padding);
+
+    // Destroy the pages and forget the sprites
+    void Clear();
+
+    const std::unordered_map<std::string, TextureComponent>& GetSprites() const {
+        return m_sprites;
+    }
+
+    std::size_t GetPageCount() const {
+        return m_pages.size();
+    }
+};
@@ -4,4 +4,5 @@
 struct TextureComponent {
     SDL_Texture* texture;
     float width, height;
+    SDL_Rect source;    // Part of the texture to draw, an atlas page holds many sprites
 };
@@ -12,7 +12,7 @@ public:
     void operator()() {
         auto gameOver = GameObject()
             .AddComponent<RenderLayer6Tag>()
-            .AddComponent<TextureComponent>( Game::LoadTexture("gfx/textgameover.png"))
+            .AddComponent<TextureComponent>( Game::GetTexture(AssetId::TEXTGAMEOVER))
             .AddComponent<ScriptComponent>( GameOverScript() );
         
         auto gameOverTex = gameOver.GetComponent<TextureComponent>();
@@ -0,0 +1,49 @@
+#pragma once
+#include "Shooter.hpp"
+#include "GameEngine/GameEngine.hpp"
+#include "GameEngine/Game.hpp"
+
+class LoadingScreen {
+public:
+    struct LoadingComponent {
+        std::size_t loaded;
+        std::size_t total;
+        std::size_t shown;
+    };
+
+    // Progress callback for Game::LoadTextureAtlasAsync
+    static void OnProgress(std::size_t loaded, std::size_t total) {
+        static GameObjectHandle loading{ "loading"_hs };
+        loading.Get().PatchComponent<LoadingComponent>([loaded, total](auto& component) {
+            component.loaded = loaded;
+            component.total = total;
+        });
+    }
+
+private:
+    struct LoadingScript: public Script {
+        // One dot per decoded image, in a row across the middle of the screen
+        void OnUpdate(GameObject& self, float dt) {
+            if(!self.HasChanged<LoadingComponent>()) return;
+            auto& loading = self.GetComponent<LoadingComponent>();
+
+            const float spacing = 40.0f;
+            const float left = SCREEN_WIDTH / 2.0f - spacing * static_cast<float>(loading.total) / 2.0f;
+            for(; loading.shown < loading.loaded; loading.shown++) {
+                GameObject()
+                    .AddComponent<TextRenderLayer>()
+                    .AddComponent<PositionComponent>(left + spacing * static_cast<float>(loading.shown), SCREEN_HEIGHT / 2.0f)
+                    .AddComponent<TextureComponent>(Game::GetTexture(AssetId::POINTS));
+            }
+        }
+    };
+
+public:
+    void operator()() {
+        Game::TrackChanges<LoadingComponent>();
+        GameObject()
+            .AddComponent<SearchableComponent>("loading"_hs)
+            .AddComponent<LoadingComponent>(std::size_t(0), std::size_t(0), std::size_t(0))
+            .AddComponent<ScriptComponent>( LoadingScript() );
+    }
+};
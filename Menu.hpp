@@ -17,7 +17,7 @@ public:
     void operator()() {
         auto title = GameObject()
             .AddComponent<RenderLayer4Tag>()
-            .AddComponent<TextureComponent>( Game::LoadTexture("gfx/title.png") )
+            .AddComponent<TextureComponent>( Game::GetTexture(AssetId::TITLE) )
             .AddComponent<ScriptComponent>( MenuScript() );
         
         const auto& titleTex = title.GetComponent<TextureComponent>();
@@ -26,7 +26,7 @@ public:
 
         auto info = GameObject()
             .AddComponent<RenderLayer4Tag>()
-            .AddComponent<TextureComponent>( Game::LoadTexture("gfx/textinfo.png") );
+            .AddComponent<TextureComponent>( Game::GetTexture(AssetId::TEXTINFO) );
         
         const auto& infoTex = info.GetComponent<TextureComponent>();
 
@@ -23,11 +23,9 @@ class Player {
         void OnCollision(GameObject& self, GameObject& other) {
             const auto& position = other.GetComponent<PositionComponent>();
             const auto& texture = other.GetComponent<TextureComponent>();
-            for(int i=0; i<15; i++) {
-                AddToGame(Explosion(position.x + texture.width / 2.0f, position.y + texture.height / 2.0f));
-            }
+            AddToGame(Explosion(position.x + texture.width / 2.0f, position.y + texture.height / 2.0f, 15));
 
-            Game::FindGameObject("playground")
+            Game::FindGameObject("playground"_hs)
                 .AddComponent<GameOverTimeoutComponent>( true, 1.0f ); // 1s
 
             self.Destroy();
@@ -39,15 +37,13 @@ public:
     void operator()() {
         auto player = GameObject()
             .AddComponent<SpaceShipRenderLayer>()
-            .AddComponent<SearchableComponent>("player")
+            .AddComponent<SearchableComponent>("player"_hs)
             .AddComponent<VelocityComponent>(0.0f, 0.0f)
-            .AddComponent<TextureComponent>(Game::LoadTexture("gfx/player.png"))
+            .AddComponent<TextureComponent>(Game::GetTexture(AssetId::PLAYER))
             .AddComponent<KeyStateComponent>()
             .AddComponent<FireCooldown>()
             .AddComponent<ScriptComponent>(PlayerScript{})
-            .AddComponent<EnemyColitionLayerTag>()
-            .AddComponent<EnemyBulletColitionLayerTag>()
-            .AddComponent<ScorePodLayerTag>()
+            .AddComponent<CollisionMaskComponent>(PLAYER_COLLISION_LAYER)
             .AddComponent<AABBComponent>(20.0f, 0.0f, -20.0f, 0.0f, false);
         
         const auto& tex = player.GetComponent<TextureComponent>();
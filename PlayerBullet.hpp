@@ -20,9 +20,7 @@ class PlayerBullet {
         void OnCollision(GameObject& self, GameObject& other) {
             const auto& position = other.GetComponent<PositionComponent>();
             const auto& texture = other.GetComponent<TextureComponent>();
-            for(int i=0; i<10; i++) {
-                AddToGame(Explosion(position.x + texture.width / 2.0f, position.y + texture.height / 2.0f));
-            }
+            AddToGame(Explosion(position.x + texture.width / 2.0f, position.y + texture.height / 2.0f, 10));
 
             AddToGame( ScorePod(position.x + texture.width / 2.0f, position.y + texture.height / 2.0f) );
 
@@ -35,12 +33,12 @@ public:
     PlayerBullet(float x, float y): m_x(x), m_y(y) {}
 
     void operator()() {
-        auto gameObject = GameObject()
+        auto gameObject = GameObject::FromPool<PlayerBullet>()
             .AddComponent<BulletRenderLayer>()
             .AddComponent<VelocityComponent>( PLAYER_BULLET_SPEED, 0.0f )
-            .AddComponent<TextureComponent>( Game::LoadTexture("gfx/playerbullet.png") )
+            .AddComponent<TextureComponent>( Game::GetTexture(AssetId::PLAYERBULLET) )
             .AddComponent<ScriptComponent>(PlayerBulletScript())
-            .AddComponent<PlayerBulletColitionLayerTag>()
+            .AddComponent<CollisionMaskComponent>(PLAYER_BULLET_COLLISION_LAYER)
             .AddComponent<AABBComponent>(0.0f, 0.0f, 0.0f, 0.0f, false);
         
         auto& textureComponent = gameObject.GetComponent<TextureComponent>();
@@ -28,7 +28,7 @@ class Playground {
 public:
     void operator()() {
         GameObject()
-            .AddComponent<SearchableComponent>("playground")
+            .AddComponent<SearchableComponent>("playground"_hs)
             .AddComponent<ScriptComponent>( PlaygroundScript() );
 
         AddToGame( Player() );
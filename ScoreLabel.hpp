@@ -1,4 +1,5 @@
 #pragma once
+#include "Shooter.hpp"
 #include "GameEngine/GameEngine.hpp"
 
 class ScoreLabel {
@@ -13,47 +14,52 @@ public:
 
 private:
     struct ScoreLabelScript: public Script {
+        static const TextureComponent& digit(int value) {
+            static constexpr AssetId digits[] = {
+                AssetId::NUM0, AssetId::NUM1, AssetId::NUM2, AssetId::NUM3, AssetId::NUM4,
+                AssetId::NUM5, AssetId::NUM6, AssetId::NUM7, AssetId::NUM8, AssetId::NUM9
+            };
+            return Game::GetTexture(digits[value % 10]);
+        }
+
         void OnUpdate(GameObject& self, float dt) {
-            auto score = self.GetComponent<ScoreLabelComponent>();
+            // The digits only change with the score
+            if(!self.HasChanged<ScoreLabelComponent>()) return;
+            auto& score = self.GetComponent<ScoreLabelComponent>();
 
             // Update the texture depended on the score
             if(score.score >= 0 && score.score <= 9) {
-                std::string dig0 = std::string("gfx/num") + std::to_string(score.score) + ".png";
-                score.digit0.AddComponent<TextureComponent>( Game::LoadTexture(dig0.c_str()) );
+                score.digit0.AddComponent<TextureComponent>( digit(score.score) );
                 score.digit1.RemoveComponent<TextureComponent>();
                 score.digit2.RemoveComponent<TextureComponent>();
             }
             else if(score.score >= 10 && score.score <= 99) {
-                std::string dig0 = std::string("gfx/num") + std::to_string((score.score / 10) % 10) + ".png";
-                std::string dig1 = std::string("gfx/num") + std::to_string(score.score % 10) + ".png";
-                score.digit0.AddComponent<TextureComponent>( Game::LoadTexture(dig0.c_str()) );
-                score.digit1.AddComponent<TextureComponent>( Game::LoadTexture(dig1.c_str()) );
+                score.digit0.AddComponent<TextureComponent>( digit(score.score / 10) );
+                score.digit1.AddComponent<TextureComponent>( digit(score.score) );
                 score.digit2.RemoveComponent<TextureComponent>();
             }
             else if(score.score >= 100 && score.score <= 999) {
-                std::string dig0 = std::string("gfx/num") + std::to_string((score.score / 100) % 10) + ".png";
-                std::string dig1 = std::string("gfx/num") + std::to_string((score.score / 10) % 10) + ".png";
-                std::string dig2 = std::string("gfx/num") + std::to_string(score.score % 10) + ".png";
-                score.digit0.AddComponent<TextureComponent>( Game::LoadTexture(dig0.c_str()) );
-                score.digit1.AddComponent<TextureComponent>( Game::LoadTexture(dig1.c_str()) );
-                score.digit2.AddComponent<TextureComponent>( Game::LoadTexture(dig2.c_str()) );
+                score.digit0.AddComponent<TextureComponent>( digit(score.score / 100) );
+                score.digit1.AddComponent<TextureComponent>( digit(score.score / 10) );
+                score.digit2.AddComponent<TextureComponent>( digit(score.score) );
             }
         }
     };
 
 public:
     void operator()() {
+        Game::TrackChanges<ScoreLabelComponent>();
         GameObject()
-            .AddComponent<SearchableComponent>("score")
+            .AddComponent<SearchableComponent>("score"_hs)
             .AddComponent<ScoreLabelComponent>(0
                 , GameObject()
                     .AddComponent<TextRenderLayer>()
                     .AddComponent<PositionComponent>(SCREEN_WIDTH - 256.0f, 30.0f)
-                    .AddComponent<TextureComponent>(Game::LoadTexture("gfx/textscore.png"))
+                    .AddComponent<TextureComponent>(Game::GetTexture(AssetId::TEXTSCORE))
                 , GameObject()
                     .AddComponent<TextRenderLayer>()
                     .AddComponent<PositionComponent>(SCREEN_WIDTH - 156.0f, 30.0f)
-                    .AddComponent<TextureComponent>(Game::LoadTexture("gfx/num0.png"))
+                    .AddComponent<TextureComponent>(Game::GetTexture(AssetId::NUM0))
                 , GameObject()
                     .AddComponent<TextRenderLayer>()
                     .AddComponent<PositionComponent>(SCREEN_WIDTH - 134.0f, 30.0f)
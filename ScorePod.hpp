@@ -24,7 +24,8 @@ class ScorePod {
             self.Destroy();
 
             // Update the score with one
-            Game::FindGameObject("score").GetComponent<ScoreLabel::ScoreLabelComponent>().score++;
+            static GameObjectHandle score{ "score"_hs };
+            score.Get().PatchComponent<ScoreLabel::ScoreLabelComponent>([](auto& label) { label.score++; });
         }
     };
 
@@ -37,13 +38,13 @@ public:
         float dx = cosf(ran) * speed;
         float dy = sinf(ran) * speed;
         
-        GameObject()
+        GameObject::FromPool<ScorePod>()
             .AddComponent<BulletRenderLayer>()
-            .AddComponent<ScorePodLayerTag>()
+            .AddComponent<CollisionMaskComponent>(SCORE_POD_COLLISION_LAYER)
             .AddComponent<AABBComponent>(0.0f, 0.0f, 0.0f, 0.0f, false)
             .AddComponent<PositionComponent>(m_x, m_y)
             .AddComponent<VelocityComponent>(dx, dy)
-            .AddComponent<TextureComponent>(Game::LoadTexture("gfx/points.png"))
+            .AddComponent<TextureComponent>(Game::GetTexture(AssetId::POINTS))
             .AddComponent<ScriptComponent>(ScorePodScript());
     }
 };
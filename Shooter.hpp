@@ -1,10 +1,15 @@
 #pragma once
 #include "GameEngine/Game.hpp"
 
-using PlayerBulletColitionLayerTag = ColitionLayer1Tag;
-using EnemyColitionLayerTag = ColitionLayer2Tag;
-using EnemyBulletColitionLayerTag = ColitionLayer3Tag;
-using ScorePodLayerTag = ColitionLayer4Tag;
+// Names of searchable game objects are hashed at compile time, "player"_hs
+using namespace entt::literals;
+
+// Collision layers
+constexpr uint32_t PLAYER_BULLET_COLLISION_LAYER = 1u << 0;
+constexpr uint32_t ENEMY_COLLISION_LAYER = 1u << 1;
+constexpr uint32_t PLAYER_COLLISION_LAYER = 1u << 2;
+constexpr uint32_t ENEMY_BULLET_COLLISION_LAYER = 1u << 3;
+constexpr uint32_t SCORE_POD_COLLISION_LAYER = 1u << 4;
 
 using StarBackgroundLayer = RenderLayer1Tag;
 using SpaceShipRenderLayer = RenderLayer4Tag;
@@ -34,3 +39,6 @@ constexpr float ENEMY_MAX_SPEED = 200.0f;
 constexpr float ENEMY_BULLET_SPEED = 230.0f;
 constexpr float ENEMY_BULLET_SPAWN_TIMEOUT_MIN = 1.5f;
 constexpr float ENEMY_BULLET_SPAWN_TIMEOUT_MAX = 2.5f;
+
+// Stars, one new star per update spread over the three speed bands
+constexpr float STAR_SPAWN_RATE = 1.0f / SECOND_PER_FRAME;
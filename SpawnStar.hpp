@@ -1,24 +1,29 @@
 #pragma once
 #include "Shooter.hpp"
 #include "GameEngine/GameEngine.hpp"
-#include "Star.hpp"
+#include "GameEngine/Game.hpp"
 
 class SpawnStar {
-    struct SpawnStarScript: public Script {
-        void OnConstructed(GameObject& self) {
-            for(int x=0; x<SCREEN_WIDTH; x++) {
-                AddToGame( Star(x) );
-            }
-        }
-
-        void OnUpdate(GameObject& self, float dt) {
-            AddToGame( Star(SCREEN_WIDTH) );
-        };
-    };
+    // Enough stars for the density a band had when every star was an entity
+    static ParallaxComponent::Band band(float speed, Uint8 alpha) {
+        const int count = static_cast<int>(SCREEN_WIDTH * STAR_SPAWN_RATE / 3.0f / -speed);
+        return ParallaxComponent::Band{ speed, count, SDL_Color{ 255, 255, 255, alpha } };
+    }
 
 public:
     void operator()() {
         GameObject()
-            .AddComponent<ScriptComponent>( SpawnStarScript() );
+            .AddComponent<StarBackgroundLayer>()
+            .AddComponent<ParallaxComponent>(ParallaxComponent{
+                {
+                    Game::GetTexture(AssetId::STAR1),
+                    Game::GetTexture(AssetId::STAR2),
+                    Game::GetTexture(AssetId::STAR3),
+                    Game::GetTexture(AssetId::STAR4)
+                },
+                { band(-100.0f, 64), band(-200.0f, 92), band(-300.0f, 128) },
+                SCREEN_WIDTH, SCREEN_HEIGHT,
+                Game::GetRandom().Next()
+            });
     }
 };